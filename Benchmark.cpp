@@ -0,0 +1,847 @@
+/**
+ * Micro-benchmark suite for the Fraction class.
+ *
+ * A small self-contained harness in the spirit of Google Benchmark: every benchmark runs a batch of operations over
+ * pre-generated operands, the batch size is grown until a run takes at least --min-time seconds, and the run is
+ * repeated --repetitions times. The median time per operation is reported.
+ *
+ * Usage: ./fraction_bench [--filter=substring] [--format=console|json|csv] [--min-time=seconds] [--repetitions=n]
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <limits>
+#include <random>
+#include <sstream>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "sources/AdaptiveFraction.hpp"
+#include "sources/AtomicFraction.hpp"
+#include "sources/BigFraction.hpp"
+#include "sources/Fraction.hpp"
+#include "sources/FractionCache.hpp"
+#include "sources/FractionFlatMap.hpp"
+#include "sources/FractionHash.hpp"
+#include "sources/FractionIndex.hpp"
+#include "sources/FractionIntern.hpp"
+#include "sources/FractionInterval.hpp"
+#include "sources/FractionMatrix.hpp"
+#include "sources/FractionSort.hpp"
+#include "sources/FractionStats.hpp"
+#include "sources/LimbArena.hpp"
+#include "sources/LinearProgram.hpp"
+#include "sources/PackedFraction.hpp"
+#include "sources/RationalPolynomial.hpp"
+#include "sources/ShardedFractionCounter.hpp"
+
+using namespace std;
+
+namespace {
+
+/**
+ * Prevents the compiler from optimising away a computed value.
+ */
+template<class T>
+inline void doNotOptimize(const T &value) {
+    asm volatile("" : : "r,m"(value) : "memory");
+}
+
+const size_t OPERAND_COUNT = 4096;
+
+/**
+ * A set of pre-generated operands drawn from one size distribution.
+ * Values are bounded so that the fixed-width arithmetic never overflows; float operands are kept below 64 so that their
+ * 1/1000 denominators can be combined with every denominator in the set, and packed operands are kept within 63/127 so
+ * that results of PackedFraction arithmetic still fit in 16-bit parts.
+ */
+struct Operands {
+    string name;
+    vector<Fraction> left;
+    vector<Fraction> right;
+    vector<float> floats;
+    vector<pair<int, int>> raw;
+    vector<PackedFraction> packedLeft;
+    vector<PackedFraction> packedRight;
+    string text;
+};
+
+Operands makeOperands(const string &name, int maxNumerator, int maxDenominator, uint32_t seed) {
+    mt19937 rng(seed);
+    uniform_int_distribution<int> numerators(-maxNumerator, maxNumerator);
+    uniform_int_distribution<int> denominators(1, maxDenominator);
+    int maxFloat = std::min(maxNumerator, 64) * 1000;
+    uniform_int_distribution<int> thousandths(-maxFloat, maxFloat);
+    uniform_int_distribution<int> packedNumerators(-std::min(maxNumerator, 63), std::min(maxNumerator, 63));
+    uniform_int_distribution<int> packedDenominators(1, std::min(maxDenominator, 127));
+
+    Operands operands;
+    operands.name = name;
+    ostringstream text;
+    for (size_t i = 0; i < OPERAND_COUNT; ++i) {
+        int n = numerators(rng);
+        int d = denominators(rng);
+        operands.raw.emplace_back(n, d);
+        operands.left.emplace_back(n, d);
+        operands.right.emplace_back(numerators(rng), denominators(rng));
+        if (operands.right.back() == 0) operands.right.back() = Fraction(1, d);
+        operands.floats.push_back(static_cast<float>(thousandths(rng)) / 1000.0f);
+        operands.packedLeft.emplace_back(packedNumerators(rng), packedDenominators(rng));
+        operands.packedRight.emplace_back(packedNumerators(rng), packedDenominators(rng));
+        if (operands.packedRight.back() == PackedFraction()) operands.packedRight.back() = PackedFraction(1, 2);
+        text << n << '/' << d << ' ';
+    }
+    operands.text = text.str();
+    return operands;
+}
+
+/**
+ * Operand distributions: small parts, medium parts, and parts up to 2^15 so that every product still fits in an int.
+ */
+vector<Operands> makeDistributions() {
+    return {makeOperands("small", 16, 16, 1),
+            makeOperands("medium", 1000, 1000, 2),
+            makeOperands("large", 32767, 32767, 3)};
+}
+
+/**
+ * A benchmark body performs the given number of operations using the operands.
+ */
+using BenchBody = function<void(const Operands &, size_t)>;
+
+struct Benchmark {
+    string name;
+    BenchBody body;
+};
+
+struct BenchResult {
+    string name;
+    string distribution;
+    size_t iterations;
+    double nsPerOp;
+};
+
+template<class Op>
+BenchBody binaryOp(Op op) {
+    return [op](const Operands &operands, size_t iterations) {
+        for (size_t i = 0; i < iterations; ++i) {
+            size_t index = i % OPERAND_COUNT;
+            doNotOptimize(op(operands.left[index], operands.right[index]));
+        }
+    };
+}
+
+/**
+ * The n ^ d hash that the std::hash specialisation replaces, kept as a baseline for the group-by benchmarks.
+ */
+struct NaiveFractionHash {
+    size_t operator()(const Fraction &fraction) const {
+        return static_cast<size_t>(static_cast<unsigned>(fraction.getNumerator() ^ fraction.getDenominator()));
+    }
+};
+
+/**
+ * Counts the operands per value in an unordered_map, rebuilding the map after every pass over the operands.
+ */
+template<class Hash>
+BenchBody groupBy() {
+    return [](const Operands &operands, size_t iterations) {
+        unordered_map<Fraction, int, Hash> counts;
+        for (size_t i = 0; i < iterations; ++i) {
+            if (i % OPERAND_COUNT == 0) counts.clear();
+            ++counts[operands.left[i % OPERAND_COUNT]];
+        }
+        doNotOptimize(counts.size());
+    };
+}
+
+/**
+ * Sorts copies of the operands; one operation is one element sorted.
+ */
+template<class Sort>
+BenchBody sortOp(Sort sortFractions) {
+    return [sortFractions](const Operands &operands, size_t iterations) {
+        vector<Fraction> fractions;
+        for (size_t done = 0; done < iterations; done += OPERAND_COUNT) {
+            fractions.assign(operands.left.begin(), operands.left.end());
+            sortFractions(fractions);
+            doNotOptimize(fractions.front());
+        }
+    };
+}
+
+template<class Op>
+BenchBody packedOp(Op op) {
+    return [op](const Operands &operands, size_t iterations) {
+        for (size_t i = 0; i < iterations; ++i) {
+            size_t index = i % OPERAND_COUNT;
+            doNotOptimize(op(operands.packedLeft[index], operands.packedRight[index]));
+        }
+    };
+}
+
+template<class Op>
+BenchBody floatOp(Op op) {
+    return [op](const Operands &operands, size_t iterations) {
+        for (size_t i = 0; i < iterations; ++i) {
+            size_t index = i % OPERAND_COUNT;
+            doNotOptimize(op(operands.left[index], operands.floats[index]));
+        }
+    };
+}
+
+/**
+ * Multiplies two fixed pseudo-random integers of the given length in limbs, with the multiplication thresholds set as
+ * given for the duration of the run. Used to tune BigInt::DEFAULT_KARATSUBA_THRESHOLD and DEFAULT_TOOM3_THRESHOLD by
+ * comparing, at each length, the forced algorithms with the default dispatch.
+ */
+BenchBody bigMultiplyOp(size_t limbs, size_t karatsuba, size_t toom3) {
+    mt19937_64 rng(limbs);
+    BigInt left = 1;
+    BigInt right = 1;
+    for (size_t i = 0; i < limbs; ++i) {
+        left = left * BigInt(int64_t{1} << 32) + BigInt(static_cast<int64_t>(rng() >> 32U));
+        right = right * BigInt(int64_t{1} << 32) + BigInt(static_cast<int64_t>(rng() >> 32U));
+    }
+    return [left, right, karatsuba, toom3](const Operands &, size_t iterations) {
+        size_t defaultKaratsuba = BigInt::karatsubaThreshold();
+        size_t defaultToom3 = BigInt::toom3Threshold();
+        BigInt::setMultiplyThresholds(karatsuba, toom3);
+        for (size_t i = 0; i < iterations; ++i) doNotOptimize((left * right).limbCount());
+        BigInt::setMultiplyThresholds(defaultKaratsuba, defaultToom3);
+    };
+}
+
+/**
+ * Runs every iteration of body in its own ArenaScope, so that the scratch of each operation comes from the arena and
+ * is released at once.
+ */
+BenchBody inArena(BenchBody body) {
+    return [body](const Operands &operands, size_t iterations) {
+        for (size_t i = 0; i < iterations; ++i) {
+            ArenaScope scope;
+            body(operands, 1);
+        }
+    };
+}
+
+/**
+ * Takes the gcd of two fixed pseudo-random integers of the given length in limbs, with a common factor of a quarter of
+ * that length, using the given half-gcd threshold. Used to tune BigInt::DEFAULT_HALF_GCD_THRESHOLD against Lehmer's
+ * algorithm alone.
+ */
+BenchBody bigGcdOp(size_t limbs, size_t halfGcd) {
+    mt19937_64 rng(limbs);
+    BigInt left = 1;
+    BigInt right = 1;
+    BigInt common = 1;
+    for (size_t i = 0; i < limbs; ++i) {
+        left = left * BigInt(int64_t{1} << 32) + BigInt(static_cast<int64_t>(rng() >> 32U));
+        right = right * BigInt(int64_t{1} << 32) + BigInt(static_cast<int64_t>(rng() >> 32U));
+        if (i % 4 == 0) common = common * BigInt(int64_t{1} << 32) + BigInt(static_cast<int64_t>(rng() >> 32U));
+    }
+    left *= common;
+    right *= common;
+    return [left, right, halfGcd](const Operands &, size_t iterations) {
+        size_t defaultHalfGcd = BigInt::halfGcdThreshold();
+        BigInt::setHalfGcdThreshold(halfGcd);
+        for (size_t i = 0; i < iterations; ++i) doNotOptimize(BigInt::gcd(left, right).limbCount());
+        BigInt::setHalfGcdThreshold(defaultHalfGcd);
+    };
+}
+
+/**
+ * An n x n matrix filled with consecutive operands, starting at the given offset.
+ */
+FractionMatrix operandMatrix(const Operands &operands, size_t n, size_t offset) {
+    FractionMatrix matrix(n, n);
+    for (size_t i = 0; i < n * n; ++i) matrix.data()[i] = operands.left[(offset + i) % OPERAND_COUNT];
+    return matrix;
+}
+
+/**
+ * The textbook determinant: Gaussian elimination with BigFraction division, reducing every updated entry. The
+ * baseline for FractionMatrix::determinant.
+ */
+BigFraction gaussianDeterminant(const FractionMatrix &matrix) {
+    size_t n = matrix.rows();
+    vector<BigFraction> a(matrix.data(), matrix.data() + n * n);
+    BigFraction determinant = 1;
+    for (size_t k = 0; k < n; ++k) {
+        size_t pivot = k;
+        while (pivot < n && a[pivot * n + k] == BigFraction()) ++pivot;
+        if (pivot == n) return {};
+        if (pivot != k) {
+            for (size_t j = 0; j < n; ++j) swap(a[k * n + j], a[pivot * n + j]);
+            determinant = -determinant;
+        }
+        determinant *= a[k * n + k];
+        for (size_t i = k + 1; i < n; ++i) {
+            BigFraction factor = a[i * n + k] / a[k * n + k];
+            for (size_t j = k + 1; j < n; ++j) a[i * n + j] -= factor * a[k * n + j];
+        }
+    }
+    return determinant;
+}
+
+template<class Op>
+BenchBody matrixOp(size_t n, Op op) {
+    return [n, op](const Operands &operands, size_t iterations) {
+        for (size_t i = 0; i < iterations; ++i) doNotOptimize(op(operandMatrix(operands, n, i * n)));
+    };
+}
+
+/**
+ * The textbook product: one Fraction multiply and add, each with its gcd, per inner-product term. The baseline for
+ * FractionMatrix::multiply.
+ */
+FractionMatrix naiveProduct(const FractionMatrix &left, const FractionMatrix &right) {
+    FractionMatrix product(left.rows(), right.columns());
+    for (size_t i = 0; i < left.rows(); ++i) {
+        for (size_t j = 0; j < right.columns(); ++j) {
+            Fraction sum;
+            for (size_t k = 0; k < left.columns(); ++k) sum = sum + left(i, k) * right(k, j);
+            product(i, j) = sum;
+        }
+    }
+    return product;
+}
+
+/**
+ * Squares an n x n matrix of small fractions, built once at registration so that the sums stay within int.
+ * @param threads The threads for FractionMatrix::multiply; naive selects naiveProduct instead.
+ */
+BenchBody matrixProductOp(size_t n, unsigned threads, bool naive) {
+    mt19937 rng(static_cast<unsigned>(n));
+    uniform_int_distribution<int> numerators(-9, 9);
+    uniform_int_distribution<int> denominators(1, 6);
+    FractionMatrix matrix(n, n);
+    for (size_t i = 0; i < n * n; ++i) matrix.data()[i] = Fraction(numerators(rng), denominators(rng));
+    return [matrix, threads, naive](const Operands &, size_t iterations) {
+        for (size_t i = 0; i < iterations; ++i) {
+            FractionMatrix product =
+                    naive ? naiveProduct(matrix, matrix) : FractionMatrix::multiply(matrix, matrix, threads);
+            doNotOptimize(product(0, 0).getDenominator());
+        }
+    };
+}
+
+/**
+ * A random program max c x subject to A x <= b, with positive fractional data, so the origin is feasible and the
+ * optimum is bounded.
+ */
+struct PackingProgram {
+    vector<vector<Fraction>> coefficients;
+    vector<Fraction> bounds;
+    vector<Fraction> objective;
+};
+
+PackingProgram packingProgram(size_t size) {
+    mt19937 rng(static_cast<unsigned>(size));
+    uniform_int_distribution<int> digits(1, 9);
+    PackingProgram program;
+    program.coefficients.assign(size, vector<Fraction>(size));
+    for (size_t row = 0; row < size; ++row) {
+        for (Fraction &coefficient: program.coefficients[row]) coefficient = Fraction(digits(rng), digits(rng));
+        program.bounds.emplace_back(10 * digits(rng), digits(rng));
+        program.objective.emplace_back(digits(rng), digits(rng));
+    }
+    return program;
+}
+
+/**
+ * The textbook dense tableau simplex with Bland's rule on BigFractions, reducing every updated entry. The baseline for
+ * LinearProgram.
+ */
+BigFraction tableauSimplex(const PackingProgram &program) {
+    size_t rows = program.bounds.size();
+    size_t columns = program.objective.size() + rows;
+    vector<vector<BigFraction>> tableau(rows + 1, vector<BigFraction>(columns + 1));
+    vector<size_t> basis(rows);
+    for (size_t row = 0; row < rows; ++row) {
+        for (size_t j = 0; j < program.objective.size(); ++j) tableau[row][j] = program.coefficients[row][j];
+        tableau[row][program.objective.size() + row] = 1;
+        tableau[row][columns] = program.bounds[row];
+        basis[row] = program.objective.size() + row;
+    }
+    for (size_t j = 0; j < program.objective.size(); ++j) tableau[rows][j] = -BigFraction(program.objective[j]);
+    while (true) {
+        size_t entering = columns;
+        for (size_t j = 0; j < columns && entering == columns; ++j) {
+            if (tableau[rows][j] < BigFraction()) entering = j;
+        }
+        if (entering == columns) return tableau[rows][columns];
+        size_t leaving = rows;
+        BigFraction best;
+        for (size_t row = 0; row < rows; ++row) {
+            if (tableau[row][entering] <= BigFraction()) continue;
+            BigFraction ratio = tableau[row][columns] / tableau[row][entering];
+            if (leaving == rows || ratio < best || (ratio == best && basis[row] < basis[leaving])) {
+                leaving = row;
+                best = ratio;
+            }
+        }
+        BigFraction pivot = tableau[leaving][entering];
+        for (BigFraction &entry: tableau[leaving]) entry /= pivot;
+        for (size_t row = 0; row <= rows; ++row) {
+            if (row == leaving || tableau[row][entering] == BigFraction()) continue;
+            BigFraction factor = tableau[row][entering];
+            for (size_t j = 0; j <= columns; ++j) tableau[row][j] -= factor * tableau[leaving][j];
+        }
+        basis[leaving] = entering;
+    }
+}
+
+BenchBody linearProgramOp(size_t size, bool tableau) {
+    PackingProgram packing = packingProgram(size);
+    LinearProgram program(size);
+    for (size_t row = 0; row < size; ++row) {
+        vector<pair<size_t, Fraction>> terms;
+        for (size_t j = 0; j < size; ++j) terms.emplace_back(j, packing.coefficients[row][j]);
+        program.addConstraint(terms, LinearProgram::Relation::LessEqual, packing.bounds[row]);
+        program.setObjective(row, packing.objective[row]);
+    }
+    return [packing, program, tableau](const Operands &, size_t iterations) {
+        for (size_t i = 0; i < iterations; ++i) {
+            BigFraction optimum = tableau ? tableauSimplex(packing) : program.maximize().objective;
+            doNotOptimize(optimum.getDenominator().limbCount());
+        }
+    };
+}
+
+/**
+ * A fixed polynomial of the given degree with small fractional coefficients.
+ */
+RationalPolynomial benchmarkPolynomial(size_t degree) {
+    mt19937 rng(static_cast<unsigned>(degree));
+    uniform_int_distribution<int> digits(1, 9);
+    vector<Fraction> coefficients;
+    for (size_t i = 0; i <= degree; ++i) coefficients.emplace_back(digits(rng) - 5, digits(rng));
+    return RationalPolynomial(coefficients);
+}
+
+/**
+ * Iterates the logistic map x -> 7/2 x (1 - x) from 1/3, on intervals with bounded denominators or exactly on
+ * BigFractions, whose iterates double their digits every step.
+ */
+BenchBody logisticOp(size_t steps, bool exact) {
+    return [steps, exact](const Operands &, size_t iterations) {
+        for (size_t i = 0; i < iterations; ++i) {
+            if (exact) {
+                BigFraction x = Fraction(1, 3);
+                for (size_t step = 0; step < steps; ++step) x = BigFraction(Fraction(7, 2)) * x * (BigFraction(1) - x);
+                doNotOptimize(x.getDenominator().limbCount());
+            } else {
+                FractionInterval x(Fraction(1, 3), 1 << 16);
+                for (size_t step = 0; step < steps; ++step) x = Fraction(7, 2) * x * (Fraction(1, 1) - x);
+                doNotOptimize(x.getUpper().getDenominator());
+            }
+        }
+    };
+}
+
+vector<Benchmark> fractionBenchmarks() {
+    vector<Benchmark> benchmarks;
+
+    benchmarks.push_back({"construct_int", [](const Operands &operands, size_t iterations) {
+        for (size_t i = 0; i < iterations; ++i) {
+            const pair<int, int> &raw = operands.raw[i % OPERAND_COUNT];
+            doNotOptimize(Fraction(raw.first, raw.second));
+        }
+    }});
+    benchmarks.push_back({"construct_float", [](const Operands &operands, size_t iterations) {
+        for (size_t i = 0; i < iterations; ++i) {
+            doNotOptimize(Fraction(operands.floats[i % OPERAND_COUNT]));
+        }
+    }});
+    benchmarks.push_back({"construct_float_batch", [](const Operands &operands, size_t iterations) {
+        vector<Fraction> results(OPERAND_COUNT);
+        for (size_t done = 0; done < iterations; done += OPERAND_COUNT) {
+            Fraction::floatsToFractions(operands.floats.data(), OPERAND_COUNT, results.data());
+            doNotOptimize(results.back());
+        }
+    }});
+
+    benchmarks.push_back({"add", binaryOp([](const Fraction &a, const Fraction &b) { return a + b; })});
+    benchmarks.push_back({"sub", binaryOp([](const Fraction &a, const Fraction &b) { return a - b; })});
+    benchmarks.push_back({"mul", binaryOp([](const Fraction &a, const Fraction &b) { return a * b; })});
+    benchmarks.push_back({"div", binaryOp([](const Fraction &a, const Fraction &b) { return a / b; })});
+
+    benchmarks.push_back({"add_float", floatOp([](const Fraction &a, float b) { return a + b; })});
+    benchmarks.push_back({"float_add", floatOp([](const Fraction &a, float b) { return b + a; })});
+    benchmarks.push_back({"sub_float", floatOp([](const Fraction &a, float b) { return a - b; })});
+    benchmarks.push_back({"mul_float", floatOp([](const Fraction &a, float b) { return a * b; })});
+    benchmarks.push_back({"float_mul", floatOp([](const Fraction &a, float b) { return b * a; })});
+
+    benchmarks.push_back({"add_double", floatOp([](const Fraction &a, float b) { return a + static_cast<double>(b); })});
+    benchmarks.push_back({"mul_double", floatOp([](const Fraction &a, float b) { return a * static_cast<double>(b); })});
+    benchmarks.push_back({"to_double", binaryOp([](const Fraction &a, const Fraction &) { return a.to_double(); })});
+    benchmarks.push_back({"to_float", binaryOp([](const Fraction &a, const Fraction &) { return a.to_float(); })});
+    benchmarks.push_back({"to_double_batch", [](const Operands &operands, size_t iterations) {
+        vector<double> results(OPERAND_COUNT);
+        for (size_t done = 0; done < iterations; done += OPERAND_COUNT) {
+            Fraction::toDoubles(operands.left.data(), OPERAND_COUNT, results.data());
+            doNotOptimize(results.back());
+        }
+    }});
+    benchmarks.push_back({"to_float_batch", [](const Operands &operands, size_t iterations) {
+        vector<float> results(OPERAND_COUNT);
+        for (size_t done = 0; done < iterations; done += OPERAND_COUNT) {
+            Fraction::toFloats(operands.left.data(), OPERAND_COUNT, results.data());
+            doNotOptimize(results.back());
+        }
+    }});
+
+    benchmarks.push_back({"eq", binaryOp([](const Fraction &a, const Fraction &b) { return a == b; })});
+    benchmarks.push_back({"lt", binaryOp([](const Fraction &a, const Fraction &b) { return a < b; })});
+    benchmarks.push_back({"gt", binaryOp([](const Fraction &a, const Fraction &b) { return a > b; })});
+    benchmarks.push_back({"le", binaryOp([](const Fraction &a, const Fraction &b) { return a <= b; })});
+    benchmarks.push_back({"ge", binaryOp([](const Fraction &a, const Fraction &b) { return a >= b; })});
+    benchmarks.push_back({"lt_float", floatOp([](const Fraction &a, float b) { return a < b; })});
+    benchmarks.push_back({"eq_float", floatOp([](const Fraction &a, float b) { return a == b; })});
+    benchmarks.push_back({"lt_double", floatOp([](const Fraction &a, float b) { return a < static_cast<double>(b); })});
+
+    benchmarks.push_back({"parse", [](const Operands &operands, size_t iterations) {
+        istringstream in(operands.text);
+        Fraction fraction;
+        for (size_t i = 0; i < iterations; ++i) {
+            if (i % OPERAND_COUNT == 0) {
+                in.clear();
+                in.seekg(0);
+            }
+            in >> fraction;
+            doNotOptimize(fraction);
+        }
+    }});
+    benchmarks.push_back({"format", [](const Operands &operands, size_t iterations) {
+        ostringstream out;
+        for (size_t i = 0; i < iterations; ++i) {
+            if (i % OPERAND_COUNT == 0) out.str("");
+            out << operands.left[i % OPERAND_COUNT];
+        }
+        doNotOptimize(out.tellp());
+    }});
+
+    benchmarks.push_back({"hash", [](const Operands &operands, size_t iterations) {
+        std::hash<Fraction> hasher;
+        for (size_t i = 0; i < iterations; ++i) {
+            doNotOptimize(hasher(operands.left[i % OPERAND_COUNT]));
+        }
+    }});
+    benchmarks.push_back({"group_by_std_hash", groupBy<std::hash<Fraction>>()});
+    benchmarks.push_back({"group_by_naive_hash", groupBy<NaiveFractionHash>()});
+    benchmarks.push_back({"group_by_flat_map", [](const Operands &operands, size_t iterations) {
+        FractionFlatMap<int> counts;
+        for (size_t i = 0; i < iterations; ++i) {
+            if (i % OPERAND_COUNT == 0) counts.clear();
+            ++counts[operands.left[i % OPERAND_COUNT]];
+        }
+        doNotOptimize(counts.size());
+    }});
+    benchmarks.push_back({"flat_map_find_bulk", [](const Operands &operands, size_t iterations) {
+        FractionFlatMap<int> counts;
+        vector<int> ones(OPERAND_COUNT, 1);
+        counts.insertBulk(operands.left.data(), ones.data(), OPERAND_COUNT);
+        vector<const int *> found(OPERAND_COUNT);
+        for (size_t done = 0; done < iterations; done += OPERAND_COUNT) {
+            counts.findBulk(operands.right.data(), std::min(OPERAND_COUNT, iterations - done), found.data());
+            doNotOptimize(found[0]);
+        }
+    }});
+
+    benchmarks.push_back({"sort_std", sortOp([](vector<Fraction> &fractions) {
+        std::sort(fractions.begin(), fractions.end());
+    })});
+    benchmarks.push_back({"sort_radix", sortOp([](vector<Fraction> &fractions) { radixSortFractions(fractions); })});
+
+    benchmarks.push_back({"index_lower_bound", [](const Operands &operands, size_t iterations) {
+        FractionIndex index(operands.left);
+        for (size_t i = 0; i < iterations; ++i) {
+            doNotOptimize(index.lowerBound(operands.right[i % OPERAND_COUNT]));
+        }
+    }});
+    benchmarks.push_back({"scan_lower_bound", [](const Operands &operands, size_t iterations) {
+        vector<Fraction> sorted = operands.left;
+        radixSortFractions(sorted);
+        for (size_t i = 0; i < iterations; ++i) {
+            const Fraction &value = operands.right[i % OPERAND_COUNT];
+            doNotOptimize(lower_bound(sorted.begin(), sorted.end(), value) - sorted.begin());
+        }
+    }});
+
+    benchmarks.push_back({"atomic_fetch_add", [](const Operands &operands, size_t iterations) {
+        AtomicFraction total;
+        for (size_t i = 0; i < iterations; i += 2) {
+            total.fetch_add(operands.left[i % OPERAND_COUNT]);
+            total.fetch_sub(operands.left[i % OPERAND_COUNT]);
+        }
+        doNotOptimize(total.load());
+    }});
+    benchmarks.push_back({"sharded_add", [](const Operands &operands, size_t iterations) {
+        ShardedFractionCounter total;
+        for (size_t i = 0; i < iterations; i += 2) {
+            total.add(operands.left[i % OPERAND_COUNT]);
+            total.subtract(operands.left[i % OPERAND_COUNT]);
+        }
+        doNotOptimize(total.value());
+    }});
+    benchmarks.push_back({"cached_div", binaryOp([](const Fraction &a, const Fraction &b) {
+        static FractionCache cache(size_t{1} << 16U);
+        return cache.divide(a, b);
+    })});
+    benchmarks.push_back({"cached_float", floatOp([](const Fraction &, float b) {
+        static FractionCache cache(size_t{1} << 16U);
+        return cache.floatToFraction(b);
+    })});
+
+    benchmarks.push_back({"big_add", binaryOp([](const Fraction &a, const Fraction &b) { return BigFraction(a) + b; })});
+    benchmarks.push_back({"big_mul", binaryOp([](const Fraction &a, const Fraction &b) { return BigFraction(a) * b; })});
+    benchmarks.push_back({"big_accumulate", [](const Operands &operands, size_t iterations) {
+        BigFraction total;
+        for (size_t i = 0; i < iterations; ++i) {
+            if (i % 64 == 0) total = BigFraction();
+            total += operands.left[i % OPERAND_COUNT];
+        }
+        doNotOptimize(total.getDenominator().limbCount());
+    }});
+    using Adaptive = AdaptiveFraction;
+    benchmarks.push_back({"adaptive_add", binaryOp([](const Fraction &a, const Fraction &b) { return Adaptive(a) + b; })});
+    benchmarks.push_back({"adaptive_mul", binaryOp([](const Fraction &a, const Fraction &b) { return Adaptive(a) * b; })});
+    benchmarks.push_back({"adaptive_accumulate", [](const Operands &operands, size_t iterations) {
+        AdaptiveFraction total;
+        for (size_t i = 0; i < iterations; ++i) {
+            if (i % 64 == 0) total = AdaptiveFraction();
+            total += operands.left[i % OPERAND_COUNT];
+        }
+        doNotOptimize(total.getWidth());
+    }});
+    for (size_t n : {size_t{4}, size_t{8}, size_t{16}}) {
+        string suffix = "_" + to_string(n);
+        benchmarks.push_back({"matrix_det" + suffix, matrixOp(n, [](const FractionMatrix &matrix) {
+            return matrix.determinant().getDenominator().limbCount();
+        })});
+        benchmarks.push_back({"matrix_det_gauss" + suffix, matrixOp(n, [](const FractionMatrix &matrix) {
+            return gaussianDeterminant(matrix).getDenominator().limbCount();
+        })});
+        benchmarks.push_back({"matrix_solve" + suffix, matrixOp(n, [n](const FractionMatrix &matrix) {
+            return matrix.solve(vector<Fraction>(matrix.data(), matrix.data() + n)).size();
+        })});
+    }
+    for (size_t n : {size_t{16}, size_t{32}}) {
+        string suffix = "_" + to_string(n);
+        if (n > 16) {
+            benchmarks.push_back({"matrix_det" + suffix, matrixOp(n, [](const FractionMatrix &matrix) {
+                return matrix.determinant().getDenominator().limbCount();
+            })});
+            benchmarks.push_back({"matrix_solve" + suffix, matrixOp(n, [n](const FractionMatrix &matrix) {
+                return matrix.solve(vector<Fraction>(matrix.data(), matrix.data() + n)).size();
+            })});
+        }
+        benchmarks.push_back({"matrix_det_modular" + suffix, matrixOp(n, [](const FractionMatrix &matrix) {
+            return matrix.modularDeterminant().getDenominator().limbCount();
+        })});
+        benchmarks.push_back({"matrix_solve_modular" + suffix, matrixOp(n, [n](const FractionMatrix &matrix) {
+            return matrix.modularSolve(vector<Fraction>(matrix.data(), matrix.data() + n)).size();
+        })});
+    }
+    for (size_t n : {size_t{64}, size_t{256}}) {
+        string suffix = "_" + to_string(n);
+        benchmarks.push_back({"matrix_mul" + suffix, matrixProductOp(n, 0, false)});
+        benchmarks.push_back({"matrix_mul_serial" + suffix, matrixProductOp(n, 1, false)});
+    }
+    benchmarks.push_back({"matrix_mul_naive_64", matrixProductOp(64, 0, true)});
+    for (size_t degree : {size_t{4}, size_t{8}}) {
+        string suffix = "_" + to_string(degree);
+        RationalPolynomial polynomial = benchmarkPolynomial(degree);
+        benchmarks.push_back({"poly_eval" + suffix, [polynomial](const Operands &operands, size_t iterations) {
+            for (size_t i = 0; i < iterations; ++i) {
+                doNotOptimize(polynomial.evaluate(operands.left[i % OPERAND_COUNT]).getDenominator().limbCount());
+            }
+        }});
+        benchmarks.push_back({"poly_eval_batch" + suffix, [polynomial](const Operands &operands, size_t iterations) {
+            vector<BigFraction> results(OPERAND_COUNT);
+            for (size_t done = 0; done < iterations; done += OPERAND_COUNT) {
+                polynomial.evaluate(operands.left.data(), OPERAND_COUNT, results.data());
+                doNotOptimize(results.back().getDenominator().limbCount());
+            }
+        }});
+        benchmarks.push_back({"poly_eval_horner" + suffix, [polynomial, degree](const Operands &operands,
+                                                                                 size_t iterations) {
+            for (size_t i = 0; i < iterations; ++i) {
+                BigFraction value;
+                for (size_t power = degree + 1; power-- > 0;) {
+                    value = value * operands.left[i % OPERAND_COUNT] + polynomial.coefficient(power);
+                }
+                doNotOptimize(value.getDenominator().limbCount());
+            }
+        }});
+    }
+    for (size_t size : {size_t{10}, size_t{30}}) {
+        string suffix = "_" + to_string(size);
+        benchmarks.push_back({"lp_revised" + suffix, linearProgramOp(size, false)});
+        benchmarks.push_back({"lp_tableau" + suffix, linearProgramOp(size, true)});
+    }
+    for (size_t steps : {size_t{8}, size_t{12}}) {
+        string suffix = "_" + to_string(steps);
+        benchmarks.push_back({"interval_logistic" + suffix, logisticOp(steps, false)});
+        benchmarks.push_back({"logistic_exact" + suffix, logisticOp(steps, true)});
+    }
+    const size_t never = numeric_limits<size_t>::max();
+    const size_t karatsuba = BigInt::DEFAULT_KARATSUBA_THRESHOLD;
+    for (size_t limbs : {size_t{16}, size_t{32}, size_t{64}, size_t{128}, size_t{256}, size_t{1024}}) {
+        string suffix = "_" + to_string(limbs);
+        benchmarks.push_back({"big_mul" + suffix, bigMultiplyOp(limbs, karatsuba, BigInt::DEFAULT_TOOM3_THRESHOLD)});
+        benchmarks.push_back({"big_mul_arena" + suffix,
+                              inArena(bigMultiplyOp(limbs, karatsuba, BigInt::DEFAULT_TOOM3_THRESHOLD))});
+        benchmarks.push_back({"big_mul_schoolbook" + suffix, bigMultiplyOp(limbs, never, never)});
+        benchmarks.push_back({"big_mul_karatsuba" + suffix, bigMultiplyOp(limbs, karatsuba, never)});
+        benchmarks.push_back({"big_mul_toom3" + suffix, bigMultiplyOp(limbs, karatsuba, 2 * karatsuba)});
+    }
+    for (size_t limbs : {size_t{16}, size_t{128}, size_t{1024}, size_t{2048}, size_t{4096}}) {
+        string suffix = "_" + to_string(limbs);
+        benchmarks.push_back({"big_gcd" + suffix, bigGcdOp(limbs, BigInt::DEFAULT_HALF_GCD_THRESHOLD)});
+        benchmarks.push_back({"big_gcd_arena" + suffix, inArena(bigGcdOp(limbs, BigInt::DEFAULT_HALF_GCD_THRESHOLD))});
+        benchmarks.push_back({"big_gcd_lehmer" + suffix, bigGcdOp(limbs, never)});
+        benchmarks.push_back({"big_gcd_half" + suffix, bigGcdOp(limbs, limbs / 2)});
+    }
+
+    benchmarks.push_back({"intern_hit", [](const Operands &operands, size_t iterations) {
+        static FractionInternTable table(size_t{1} << 17U);
+        for (size_t i = 0; i < iterations; ++i) {
+            const pair<int, int> &raw = operands.raw[i % OPERAND_COUNT];
+            doNotOptimize(table.intern(raw.first, raw.second));
+        }
+    }});
+    benchmarks.push_back({"intern_float_hit", [](const Operands &operands, size_t iterations) {
+        static FractionInternTable table(size_t{1} << 17U);
+        for (size_t i = 0; i < iterations; ++i) {
+            doNotOptimize(table.internFloat(operands.floats[i % OPERAND_COUNT]));
+        }
+    }});
+
+    using Packed = const PackedFraction &;
+    benchmarks.push_back({"packed_add", packedOp([](Packed a, Packed b) { return a + b; })});
+    benchmarks.push_back({"packed_mul", packedOp([](Packed a, Packed b) { return a * b; })});
+    benchmarks.push_back({"packed_div", packedOp([](Packed a, Packed b) { return a / b; })});
+    benchmarks.push_back({"packed_lt", packedOp([](Packed a, Packed b) { return a < b; })});
+    benchmarks.push_back({"packed_widen", packedOp([](Packed a, Packed) { return a.toFraction(); })});
+
+    return benchmarks;
+}
+
+struct Options {
+    string filter;
+    string format = "console";
+    double minTime = 0.2;
+    size_t repetitions = 3;
+};
+
+double runOnce(const Benchmark &benchmark, const Operands &operands, size_t iterations) {
+    auto start = chrono::steady_clock::now();
+    benchmark.body(operands, iterations);
+    auto stop = chrono::steady_clock::now();
+    return chrono::duration<double>(stop - start).count();
+}
+
+/**
+ * Grows the iteration count until one run lasts at least minTime seconds, then reports the median of the repetitions.
+ */
+BenchResult runBenchmark(const Benchmark &benchmark, const Operands &operands, const Options &options) {
+    size_t iterations = 1;
+    double elapsed = runOnce(benchmark, operands, iterations);
+    while (elapsed < options.minTime && iterations < (size_t{1} << 40U)) {
+        double scale = elapsed > 0 ? 1.4 * options.minTime / elapsed : 10.0;
+        scale = std::min(std::max(scale, 2.0), 10.0);
+        iterations = static_cast<size_t>(static_cast<double>(iterations) * scale);
+        elapsed = runOnce(benchmark, operands, iterations);
+    }
+
+    vector<double> samples{elapsed};
+    for (size_t i = 1; i < options.repetitions; ++i) {
+        samples.push_back(runOnce(benchmark, operands, iterations));
+    }
+    sort(samples.begin(), samples.end());
+    double median = samples[samples.size() / 2];
+    return {benchmark.name, operands.name, iterations, median * 1e9 / static_cast<double>(iterations)};
+}
+
+void printConsole(const vector<BenchResult> &results) {
+    cout << left << setw(24) << "benchmark" << setw(10) << "operands" << right << setw(16) << "iterations"
+         << setw(14) << "ns/op" << '\n';
+    for (const BenchResult &result: results) {
+        cout << left << setw(24) << result.name << setw(10) << result.distribution << right << setw(16)
+             << result.iterations << setw(14) << fixed << setprecision(2) << result.nsPerOp << '\n';
+    }
+}
+
+void printJson(const vector<BenchResult> &results, const Options &options) {
+    cout << "{\n  \"context\": {\"compiler\": \"" << __VERSION__ << "\", \"min_time\": " << options.minTime
+         << ", \"repetitions\": " << options.repetitions
+         << ", \"fraction_stats\": " << (FractionStats::enabled ? "true" : "false") << "},\n  \"benchmarks\": [\n";
+    for (size_t i = 0; i < results.size(); ++i) {
+        const BenchResult &result = results[i];
+        cout << "    {\"name\": \"" << result.name << '/' << result.distribution << "\", \"iterations\": "
+             << result.iterations << ", \"ns_per_op\": " << fixed << setprecision(3) << result.nsPerOp << '}'
+             << (i + 1 < results.size() ? "," : "") << '\n';
+    }
+    cout << "  ]\n}\n";
+}
+
+void printCsv(const vector<BenchResult> &results) {
+    cout << "name,distribution,iterations,ns_per_op\n";
+    for (const BenchResult &result: results) {
+        cout << result.name << ',' << result.distribution << ',' << result.iterations << ',' << fixed
+             << setprecision(3) << result.nsPerOp << '\n';
+    }
+}
+
+bool parseOptions(int argc, char **argv, Options &options) {
+    for (int i = 1; i < argc; ++i) {
+        string arg = argv[i];
+        if (arg.rfind("--filter=", 0) == 0) {
+            options.filter = arg.substr(9);
+        } else if (arg.rfind("--format=", 0) == 0) {
+            options.format = arg.substr(9);
+        } else if (arg.rfind("--min-time=", 0) == 0) {
+            options.minTime = stod(arg.substr(11));
+        } else if (arg.rfind("--repetitions=", 0) == 0) {
+            options.repetitions = static_cast<size_t>(max(1, stoi(arg.substr(14))));
+        } else {
+            cerr << "Unknown argument: " << arg << '\n'
+                 << "Usage: " << argv[0]
+                 << " [--filter=substring] [--format=console|json|csv] [--min-time=seconds] [--repetitions=n]\n";
+            return false;
+        }
+    }
+    return true;
+}
+
+}
+
+int main(int argc, char **argv) {
+    Options options;
+    if (!parseOptions(argc, argv, options)) return 1;
+
+    vector<Operands> distributions = makeDistributions();
+    vector<BenchResult> results;
+    for (const Benchmark &benchmark: fractionBenchmarks()) {
+        for (const Operands &operands: distributions) {
+            if (!options.filter.empty() &&
+                (benchmark.name + '/' + operands.name).find(options.filter) == string::npos) {
+                continue;
+            }
+            results.push_back(runBenchmark(benchmark, operands, options));
+        }
+    }
+
+    if (options.format == "json") printJson(results, options);
+    else if (options.format == "csv") printCsv(results);
+    else printConsole(results);
+    return 0;
+}
@@ -0,0 +1,1435 @@
+#include "doctest.h"
+#include <stdexcept>
+#include <random>
+#include <thread>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+#include "sources/AdaptiveFraction.hpp"
+#include "sources/AtomicFraction.hpp"
+#include "sources/BigFraction.hpp"
+#include "sources/BigInt.hpp"
+#include "sources/Fraction.hpp"
+#include "sources/FractionCache.hpp"
+#include "sources/FractionFlatMap.hpp"
+#include "sources/FractionHash.hpp"
+#include "sources/FractionIndex.hpp"
+#include "sources/FractionIntern.hpp"
+#include "sources/FractionInterval.hpp"
+#include "sources/FractionMatrix.hpp"
+#include "sources/FractionSort.hpp"
+#include "sources/FractionStats.hpp"
+#include "sources/LimbArena.hpp"
+#include "sources/LinearProgram.hpp"
+#include "sources/PackedFraction.hpp"
+#include "sources/RationalPolynomial.hpp"
+#include "sources/ShardedFractionCounter.hpp"
+
+using namespace std;
+
+TEST_SUITE("Operation counters") {
+    TEST_CASE("Counters are zero when disabled and count hot paths when enabled") {
+        FractionStats::reset();
+        Fraction a(2, 4);
+        Fraction b = a + Fraction::floatToFraction(0.25);
+        CHECK_THROWS_AS(mul_ints(numeric_limits<int>::max(), 2), std::overflow_error);
+        CHECK_EQ(b, Fraction(3, 4));
+
+        FractionStatsSnapshot stats = FractionStats::snapshot();
+        if (FractionStats::enabled) {
+            CHECK_GE(stats[FractionCounter::Construction], 3);
+            CHECK_GE(stats[FractionCounter::Renormalisation], 1);
+            CHECK_GE(stats[FractionCounter::Gcd], 3);
+            CHECK_EQ(stats[FractionCounter::FloatConversion], 1);
+            CHECK_EQ(stats[FractionCounter::MulOverflow], 1);
+            CHECK_EQ(stats[FractionCounter::AddOverflow], 0);
+        } else {
+            for (uint64_t count: stats.counts) CHECK_EQ(count, 0);
+        }
+    }
+
+    TEST_CASE("Counters of exited threads are kept until reset") {
+        FractionStats::reset();
+        thread worker([] {
+            for (int i = 1; i <= 10; ++i) Fraction(i, 2 * i);
+        });
+        worker.join();
+        FractionStatsSnapshot stats = FractionStats::snapshot();
+        CHECK_EQ(stats[FractionCounter::Construction], FractionStats::enabled ? 10 : 0);
+
+        FractionStats::reset();
+        CHECK_EQ(FractionStats::snapshot()[FractionCounter::Construction], 0);
+        CHECK_EQ(string(FractionStats::name(FractionCounter::Gcd)), "gcd");
+    }
+}
+
+TEST_SUITE("PackedFraction") {
+    TEST_CASE("Round trip and narrowing overflow") {
+        CHECK_EQ(sizeof(PackedFraction), 4);
+        PackedFraction half(2, -4);
+        CHECK_EQ(half.getNumerator(), -1);
+        CHECK_EQ(half.getDenominator(), 2);
+        CHECK_EQ(half.toFraction(), Fraction(-1, 2));
+        CHECK_EQ(PackedFraction(Fraction(32767, 65535)).toFraction(), Fraction(32767, 65535));
+        CHECK(PackedFraction::fits(Fraction(-32768, 3)));
+        CHECK_FALSE(PackedFraction::fits(Fraction(1, 65536)));
+        CHECK_THROWS_AS(PackedFraction(Fraction(40000, 3)), std::overflow_error);
+        CHECK_THROWS_AS(PackedFraction(1, 0), std::invalid_argument);
+    }
+
+    TEST_CASE("Arithmetic stays packed and widens when mixed with Fraction") {
+        PackedFraction a(1, 3), b(1, 6);
+        CHECK((a + b).isPacked());
+        CHECK_EQ((a + b).toPacked(), PackedFraction(1, 2));
+        CHECK_EQ((a - b).toPacked(), PackedFraction(1, 6));
+        CHECK_EQ((a * b).toPacked(), PackedFraction(1, 18));
+        CHECK_EQ((a / b).toPacked(), PackedFraction(2, 1));
+        CHECK_EQ((a / b).toFraction(), Fraction(2, 1));
+        CHECK_THROWS_AS(static_cast<void>(a / PackedFraction()), std::runtime_error);
+        CHECK_EQ(a + Fraction(1, 100000), Fraction(100003, 300000));
+        CHECK_EQ(Fraction(1, 2) * b, Fraction(1, 12));
+        CHECK(b < a);
+        CHECK(PackedFraction(-32768, 1) < PackedFraction(-32767, 65535));
+        CHECK(a >= a);
+        CHECK_FALSE(a > a);
+    }
+
+    TEST_CASE("Arithmetic widens to Fraction when the result does not fit in 16-bit parts") {
+        PackedResult product = PackedFraction(1, 30000) * PackedFraction(1, 3);
+        CHECK_FALSE(product.isPacked());
+        CHECK_EQ(product.toFraction(), Fraction(1, 90000));
+        CHECK_THROWS_AS(static_cast<void>(product.toPacked()), std::overflow_error);
+        PackedFraction largest(32767, 1);
+        CHECK_EQ((largest * largest).toFraction(), Fraction(1073676289, 1));
+        CHECK_EQ((largest + largest).toFraction(), Fraction(65534, 1));
+        CHECK_EQ((PackedFraction(-32768, 1) - largest).toFraction(), Fraction(-65535, 1));
+        CHECK_THROWS_AS(static_cast<void>(PackedFraction(1, 65535) + PackedFraction(1, 65534)), std::overflow_error);
+    }
+}
+
+TEST_SUITE("Fraction interning") {
+    TEST_CASE("Equal values share a handle") {
+        FractionInternTable table(64);
+        FractionHandle half = table.intern(1, 2);
+        CHECK_EQ(table.intern(2, 4), half);
+        CHECK_EQ(table.intern(-3, -6), half);
+        CHECK_EQ(table.intern(Fraction(5, 10)), half);
+        CHECK_EQ(table.internFloat(0.5), half);
+        CHECK_NE(table.intern(1, 3), half);
+        CHECK_EQ(table.intern(0, 7), table.intern(0, -2));
+        CHECK_EQ(table.value(table.intern(6, -4)), Fraction(-3, 2));
+        CHECK_EQ(table.value(table.internFloat(0.3333)), Fraction(333, 1000));
+        CHECK_THROWS_AS(table.intern(1, 0), std::invalid_argument);
+    }
+
+    TEST_CASE("Full table and concurrent interning") {
+        FractionInternTable small(2);
+        small.intern(1, 1);
+        small.intern(2, 1);
+        CHECK_THROWS_AS(small.intern(3, 1), std::overflow_error);
+
+        FractionInternTable table(1 << 12);
+        vector<thread> workers;
+        vector<vector<uint32_t>> ids(4);
+        for (size_t t = 0; t < ids.size(); ++t) {
+            workers.emplace_back([&table, &ids, t] {
+                for (int i = 1; i <= 200; ++i) ids[t].push_back(table.intern(i * 3, 6).getId());
+            });
+        }
+        for (thread &worker: workers) worker.join();
+        for (size_t t = 1; t < ids.size(); ++t) CHECK_EQ(ids[t], ids[0]);
+        CHECK_EQ(table.intern(3, 6).getId(), ids[0][0]);
+    }
+}
+
+TEST_SUITE("Fraction hashing") {
+    TEST_CASE("Hash is consistent with equality") {
+        std::hash<Fraction> hasher;
+        CHECK_EQ(hasher(Fraction(2, 4)), hasher(Fraction(1, 2)));
+        CHECK_EQ(hasher(Fraction(0, 5)), hasher(Fraction()));
+
+        Fraction zero;
+        stringstream in("0/7");
+        in >> zero;
+        CHECK_EQ(zero, Fraction());
+        CHECK_EQ(hasher(zero), hasher(Fraction()));
+
+        unordered_map<Fraction, int> counts;
+        counts[Fraction(1, 3)] += 1;
+        counts[Fraction(2, 6)] += 1;
+        counts[Fraction(-1, 3)] += 1;
+        CHECK_EQ(counts.size(), 2);
+        CHECK_EQ(counts[Fraction(3, 9)], 2);
+    }
+
+    TEST_CASE("Small fractions spread over buckets") {
+        unordered_set<size_t> buckets;
+        size_t count = 0;
+        for (int n = -32; n <= 32; ++n) {
+            for (int d = 1; d <= 32; ++d) {
+                buckets.insert(hashFraction(Fraction::fromReduced(n, d)) & 4095U);
+                ++count;
+            }
+        }
+        // A uniform hash leaves about 4096 * (1 - e^(-2080/4096)) ~ 1627 distinct buckets.
+        CHECK_GT(buckets.size(), 1500);
+        CHECK_LE(buckets.size(), count);
+    }
+}
+
+TEST_SUITE("FractionFlatMap") {
+    TEST_CASE("Insert, find, erase and canonical zero keys") {
+        FractionFlatMap<int> map;
+        CHECK(map.insert(Fraction(1, 2), 10));
+        CHECK_FALSE(map.insert(Fraction(2, 4), 11));
+        CHECK_EQ(*map.find(Fraction(1, 2)), 11);
+        map[Fraction(0, 3)] += 5;
+        Fraction zero;
+        stringstream in("0/9");
+        in >> zero;
+        map[zero] += 1;
+        CHECK_EQ(map.size(), 2);
+        CHECK_EQ(*map.find(Fraction()), 6);
+        CHECK(map.erase(Fraction(1, 2)));
+        CHECK_FALSE(map.contains(Fraction(1, 2)));
+        CHECK_EQ(map.find(Fraction(1, 2)), nullptr);
+        CHECK_EQ(map.size(), 1);
+    }
+
+    TEST_CASE("Growth, reuse of deleted slots and bulk operations agree with unordered_map") {
+        FractionFlatMap<int> map;
+        unordered_map<Fraction, int> reference;
+        vector<Fraction> keys;
+        vector<int> values;
+        for (int i = 0; i < 3000; ++i) {
+            keys.emplace_back(i % 97 - 48, i % 89 + 1);
+            values.push_back(i);
+        }
+        map.insertBulk(keys.data(), values.data(), keys.size());
+        for (size_t i = 0; i < keys.size(); ++i) reference[keys[i]] = values[i];
+        CHECK_EQ(map.size(), reference.size());
+
+        for (size_t i = 0; i < keys.size(); i += 3) {
+            map.erase(keys[i]);
+            reference.erase(keys[i]);
+        }
+        for (int i = 0; i < 500; ++i) {
+            map[Fraction(i, 7919)] = i;
+            reference[Fraction(i, 7919)] = i;
+        }
+        CHECK_EQ(map.size(), reference.size());
+
+        vector<const int *> found(keys.size());
+        map.findBulk(keys.data(), keys.size(), found.data());
+        size_t mismatches = 0;
+        for (size_t i = 0; i < keys.size(); ++i) {
+            auto expected = reference.find(keys[i]);
+            if (expected == reference.end() ? found[i] != nullptr : found[i] == nullptr || *found[i] != expected->second) {
+                ++mismatches;
+            }
+        }
+        CHECK_EQ(mismatches, 0);
+
+        size_t visited = 0;
+        map.forEach([&visited, &reference](const Fraction &key, int value) {
+            if (reference.at(key) == value) ++visited;
+        });
+        CHECK_EQ(visited, reference.size());
+    }
+
+    TEST_CASE("FractionFlatSet") {
+        FractionFlatSet set;
+        vector<Fraction> keys{Fraction(1, 2), Fraction(2, 4), Fraction(1, 3)};
+        set.insertBulk(keys.data(), keys.size());
+        CHECK_EQ(set.size(), 2);
+        bool results[2];
+        Fraction probes[2] = {Fraction(3, 9), Fraction(1, 4)};
+        set.containsBulk(probes, 2, results);
+        CHECK(results[0]);
+        CHECK_FALSE(results[1]);
+    }
+}
+
+TEST_SUITE("Fraction radix sort") {
+    vector<Fraction> randomFractions(size_t count, int maxPart, uint32_t seed) {
+        mt19937 rng(seed);
+        uniform_int_distribution<int> numerators(-maxPart, maxPart);
+        uniform_int_distribution<int> denominators(1, maxPart);
+        vector<Fraction> fractions;
+        for (size_t i = 0; i < count; ++i) fractions.emplace_back(numerators(rng), denominators(rng));
+        return fractions;
+    }
+
+    bool sortedByValue(const vector<Fraction> &fractions) {
+        for (size_t i = 1; i < fractions.size(); ++i) {
+            if (compareFractions(fractions[i - 1], fractions[i]) > 0) return false;
+        }
+        return true;
+    }
+
+    TEST_CASE("Keys preserve order and distinguish close values exactly") {
+        int max_int = numeric_limits<int>::max();
+        int min_int = numeric_limits<int>::min();
+        CHECK_LT(fractionSortKey(Fraction::fromReduced(min_int, 1)), fractionSortKey(Fraction(-1, max_int)));
+        CHECK_LT(fractionSortKey(Fraction(-1, max_int)), fractionSortKey(Fraction(0, 1)));
+        CHECK_EQ(fractionSortKey(Fraction(1, 2)), fractionSortKey(Fraction(2, 4)));
+        CHECK_LT(fractionSortKey(Fraction(max_int - 1, 1)), fractionSortKey(Fraction(max_int, 1)));
+
+        vector<Fraction> close{Fraction(1, max_int), Fraction(1, max_int - 1), Fraction(0, 1), Fraction(-1, 3)};
+        for (int i = 0; i < 300; ++i) close.emplace_back(i % 2 == 0 ? 1 : 2, max_int - i);
+        radixSortFractions(close);
+        CHECK(sortedByValue(close));
+    }
+
+    TEST_CASE("Sequential and parallel sorts agree with std::stable_sort") {
+        for (int maxPart: {10, 1000, numeric_limits<int>::max()}) {
+            vector<Fraction> fractions = randomFractions(300000, maxPart, static_cast<uint32_t>(maxPart));
+            vector<Fraction> expected = fractions;
+            stable_sort(expected.begin(), expected.end(),
+                        [](const Fraction &a, const Fraction &b) { return compareFractions(a, b) < 0; });
+            vector<Fraction> sequential = fractions;
+            radixSortFractions(sequential);
+            vector<Fraction> parallel = fractions;
+            parallelRadixSortFractions(parallel, 4);
+            CHECK(sequential == expected);
+            CHECK(parallel == expected);
+        }
+    }
+}
+
+TEST_SUITE("FractionIndex") {
+    TEST_CASE("Bounds and ranks match a sorted vector") {
+        vector<Fraction> bands;
+        for (int i = 0; i < 1000; ++i) bands.emplace_back((i * 37) % 501 - 250, i % 17 + 1);
+        FractionIndex index(bands);
+        CHECK_EQ(index.size(), bands.size());
+
+        auto less = [](const Fraction &a, const Fraction &b) { return compareFractions(a, b) < 0; };
+        vector<Fraction> sorted = bands;
+        stable_sort(sorted.begin(), sorted.end(), less);
+
+        size_t mismatches = 0;
+        for (int n = -300; n <= 300; n += 7) {
+            Fraction probe(n, 13);
+            auto lower = static_cast<size_t>(lower_bound(sorted.begin(), sorted.end(), probe, less) - sorted.begin());
+            auto upper = static_cast<size_t>(upper_bound(sorted.begin(), sorted.end(), probe, less) - sorted.begin());
+            if (index.lowerBound(probe) != lower || index.upperBound(probe) != upper || index.rank(probe) != lower) {
+                ++mismatches;
+            }
+        }
+        CHECK_EQ(mismatches, 0);
+        CHECK_EQ(index.at(0), sorted.front());
+        CHECK_EQ(index.lowerBound(Fraction(1000, 1)), index.size());
+        CHECK_EQ(index.upperBound(Fraction(-1000, 1)), 0);
+        CHECK_EQ(index.count(Fraction(-1000, 1), Fraction(1000, 1)), index.size());
+
+        vector<Fraction> probes{Fraction(-251, 1), Fraction(0, 1), Fraction(251, 1)};
+        vector<size_t> ranks(probes.size());
+        index.lowerBoundBulk(probes.data(), probes.size(), ranks.data());
+        CHECK_EQ(ranks[0], 0);
+        CHECK_EQ(ranks[1], index.rank(Fraction()));
+        CHECK_EQ(ranks[2], index.size());
+    }
+
+    TEST_CASE("Extreme values and an empty index") {
+        int max_int = numeric_limits<int>::max();
+        FractionIndex index({Fraction(1, max_int), Fraction(max_int, 1), Fraction(-max_int, 1)});
+        CHECK_EQ(index.lowerBound(Fraction(1, max_int - 1)), 2);
+        CHECK_EQ(index.upperBound(Fraction(1, max_int)), 2);
+        FractionIndex empty({});
+        CHECK_EQ(empty.lowerBound(Fraction(1, 2)), 0);
+    }
+}
+
+TEST_SUITE("AtomicFraction") {
+    TEST_CASE("Load, store, exchange and compare-exchange") {
+        AtomicFraction value(Fraction(2, 4));
+        CHECK(value.is_lock_free());
+        CHECK_EQ(value.load(), Fraction(1, 2));
+        CHECK_EQ(value.exchange(Fraction(3, 1)), Fraction(1, 2));
+
+        Fraction expected(6, 2);
+        CHECK(value.compare_exchange_strong(expected, Fraction(1, 3)));
+        expected = Fraction(1, 2);
+        CHECK_FALSE(value.compare_exchange_strong(expected, Fraction(5, 1)));
+        CHECK_EQ(expected, Fraction(1, 3));
+
+        value.store(Fraction(-4, -8));
+        CHECK_EQ(value.load(), Fraction(1, 2));
+        CHECK_EQ(value.fetch_mul(Fraction(4, 1)), Fraction(1, 2));
+        CHECK_EQ(value.fetch_sub(Fraction(1, 2)), Fraction(2, 1));
+        CHECK_EQ(value.fetch_div(Fraction(3, 1)), Fraction(3, 2));
+        CHECK_EQ(value.load(), Fraction(1, 2));
+        CHECK_THROWS_AS(value.fetch_div(Fraction()), std::runtime_error);
+        CHECK_EQ(value.load(), Fraction(1, 2));
+    }
+
+    TEST_CASE("Concurrent fetch_add matches serial addition") {
+        AtomicFraction total;
+        vector<thread> workers;
+        for (int t = 0; t < 4; ++t) {
+            workers.emplace_back([&total] {
+                for (int i = 0; i < 1000; ++i) total.fetch_add(Fraction(1, i % 3 + 2));
+            });
+        }
+        for (thread &worker: workers) worker.join();
+        Fraction serial;
+        for (int t = 0; t < 4; ++t) {
+            for (int i = 0; i < 1000; ++i) serial = serial + Fraction(1, i % 3 + 2);
+        }
+        CHECK_EQ(total.load(), serial);
+    }
+}
+
+TEST_SUITE("ShardedFractionCounter") {
+    TEST_CASE("Concurrent adds merge to the serial sum") {
+        ShardedFractionCounter counter(3);
+        CHECK_EQ(counter.shardCount(), 3);
+        vector<thread> workers;
+        for (int t = 0; t < 8; ++t) {
+            workers.emplace_back([&counter, t] {
+                for (int i = 1; i <= 500; ++i) counter.add(Fraction(t + 1, i % 7 + 2));
+            });
+        }
+        for (thread &worker: workers) worker.join();
+
+        Fraction serial;
+        for (int t = 0; t < 8; ++t) {
+            for (int i = 1; i <= 500; ++i) serial = serial + Fraction(t + 1, i % 7 + 2);
+        }
+        CHECK_EQ(counter.value(), serial);
+
+        counter.subtract(serial);
+        CHECK_EQ(counter.value(), Fraction());
+        counter.add(Fraction(1, 3));
+        counter.reset();
+        CHECK_EQ(counter.value(), Fraction());
+    }
+
+    TEST_CASE("Shards absorb intermediate overflow") {
+        ShardedFractionCounter counter(1);
+        int max_int = numeric_limits<int>::max();
+        counter.add(Fraction(max_int, 1));
+        counter.add(Fraction(max_int, 1));
+        CHECK_THROWS_AS((void) counter.value(), std::overflow_error);
+        counter.subtract(Fraction(max_int, 1));
+        CHECK_EQ(counter.value(), Fraction(max_int, 1));
+    }
+}
+
+TEST_SUITE("FractionCache") {
+    TEST_CASE("Cached results match the operators and are counted") {
+        FractionCache cache(64);
+        CHECK_EQ(cache.capacity(), 64);
+        CHECK_EQ(cache.multiply(Fraction(2, 3), Fraction(3, 4)), Fraction(1, 2));
+        CHECK_EQ(cache.multiply(Fraction(3, 4), Fraction(4, 6)), Fraction(1, 2));
+        CHECK_EQ(cache.divide(Fraction(1, 2), Fraction(1, 4)), Fraction(2, 1));
+        CHECK_EQ(cache.divide(Fraction(1, 4), Fraction(1, 2)), Fraction(1, 2));
+        CHECK_EQ(cache.floatToFraction(0.3333), Fraction(333, 1000));
+        CHECK_EQ(cache.floatToFraction(0.3333), Fraction(333, 1000));
+        CHECK_THROWS_AS(cache.divide(Fraction(1, 2), Fraction()), std::runtime_error);
+
+        FractionCacheStats stats = cache.stats();
+        CHECK_EQ(stats.hits, 2);
+        CHECK_EQ(stats.misses, 5);
+        cache.clear();
+        CHECK_EQ(cache.stats().hits, 0);
+    }
+
+    TEST_CASE("Eviction keeps results correct") {
+        FractionCache cache(64);
+        size_t mismatches = 0;
+        for (int round = 0; round < 2; ++round) {
+            for (int i = 1; i <= 500; ++i) {
+                if (cache.multiply(Fraction(i, 7), Fraction(7, i + 1)) != Fraction(i, i + 1)) ++mismatches;
+            }
+        }
+        CHECK_EQ(mismatches, 0);
+        CHECK_GT(cache.stats().evictions, 0);
+    }
+}
+
+TEST_SUITE("Float conversion table") {
+    TEST_CASE("Table conversion matches reducing thousandths") {
+        size_t mismatches = 0;
+        for (int thousandths = -5000; thousandths <= 5000; ++thousandths) {
+            float value = static_cast<float>(thousandths) / 1000.0f;
+            int expected = static_cast<int>(abs(value) * 1000.0f) * (value < 0 ? -1 : 1);
+            Fraction converted = Fraction::floatToFraction(value);
+            if (converted != Fraction(expected, 1000) || converted.getDenominator() != Fraction(expected, 1000).getDenominator()) {
+                ++mismatches;
+            }
+        }
+        CHECK_EQ(mismatches, 0);
+        CHECK_EQ(Fraction::floatToFraction(2.5), Fraction(5, 2));
+        CHECK_EQ(Fraction::floatToFraction(-0.125).getDenominator(), 8);
+        CHECK_EQ(Fraction::floatToFraction(0.0009).getDenominator(), 1);
+    }
+
+    TEST_CASE("Batch conversion matches single conversion") {
+        vector<float> values;
+        for (int i = 0; i < 1000; ++i) values.push_back(static_cast<float>(i - 500) * 0.0137f);
+        vector<Fraction> results(values.size());
+        Fraction::floatsToFractions(values.data(), values.size(), results.data());
+        size_t mismatches = 0;
+        for (size_t i = 0; i < values.size(); ++i) {
+            if (results[i] != Fraction::floatToFraction(values[i])) ++mismatches;
+        }
+        CHECK_EQ(mismatches, 0);
+    }
+}
+
+TEST_SUITE("Double conversion") {
+    TEST_CASE("Double operands are not rounded through float") {
+        CHECK_EQ(Fraction(1, 3) + 0.1, Fraction(13, 30));
+        CHECK_EQ(0.25 * Fraction(2, 3), Fraction(1, 6));
+        CHECK_EQ(Fraction(2, 3), 2.0 / 3.0);
+        CHECK_EQ(1.0L / 7.0L, Fraction(1, 7));
+        CHECK_LT(Fraction(1, 3), 0.334);
+        CHECK_GT(0.334, Fraction(1, 3));
+        CHECK_THROWS_AS(Fraction(1, 2) / 0.0, std::runtime_error);
+    }
+
+    TEST_CASE("Comparisons agree with each other at the precision of the operand") {
+        CHECK_LT(Fraction(1, 3), 0.3334);
+        CHECK_LE(Fraction(1, 3), 0.3334);
+        CHECK_FALSE(Fraction(1, 3) == 0.3334);
+        CHECK_NE(0.3334, Fraction(1, 3));
+        CHECK_EQ(12.963, Fraction(12963, 1000));
+        CHECK_LT(Fraction(1, 3), 1.0L / 3.0L + 0x1p-60L);
+        CHECK_GT(Fraction(1, 3), 1.0L / 3.0L - 0x1p-60L);
+        CHECK_GT(Fraction(1, 1000000), 0x1p-1000);
+        CHECK_LT(Fraction(numeric_limits<int>::max(), 1), numeric_limits<double>::infinity());
+        double nan = std::nan("");
+        CHECK_FALSE(Fraction(1, 2) == nan);
+        CHECK_FALSE(Fraction(1, 2) < nan);
+        CHECK_FALSE(nan >= Fraction(1, 2));
+        CHECK(Fraction(1, 2) != nan);
+
+        // Exactly one of <, == and > holds, matching the order of the correctly rounded quotient.
+        mt19937 random(47);
+        uniform_int_distribution<int> numerators(-1000, 1000);
+        uniform_int_distribution<int> denominators(1, 1000);
+        size_t mismatches = 0;
+        for (size_t trial = 0; trial < 2000; ++trial) {
+            Fraction fraction(numerators(random), denominators(random));
+            double value = trial % 2 == 0 ? numerators(random) / 8.0
+                                          : static_cast<double>(numerators(random)) / denominators(random);
+            int order = (fraction > value) + (fraction == value) + (fraction < value);
+            double quotient = static_cast<double>(fraction.getNumerator()) / fraction.getDenominator();
+            if (order != 1 || (fraction < value) != (quotient < value) || (value >= fraction) != (value >= quotient)) {
+                ++mismatches;
+            }
+        }
+        CHECK_EQ(mismatches, 0);
+    }
+
+    TEST_CASE("Best approximation with a bounded denominator") {
+        size_t mismatches = 0;
+        for (int thousandths = -5000; thousandths <= 5000; ++thousandths) {
+            if (Fraction::approximate(thousandths / 1000.0) != Fraction(thousandths, 1000)) ++mismatches;
+        }
+        CHECK_EQ(mismatches, 0);
+        CHECK_EQ(Fraction::approximate(3.14159265358979L, 1000), Fraction(355, 113));
+        CHECK_EQ(Fraction::approximate(3.14159265358979L, 100), Fraction(311, 99));
+        CHECK_EQ(Fraction::approximate(0.0006), Fraction(1, 1000));
+        CHECK_EQ(Fraction::approximate(-0.0004), Fraction(0, 1));
+        CHECK_EQ(Fraction::approximate(-2.5), Fraction(-5, 2));
+        CHECK_THROWS_AS(Fraction::approximate(3e9), std::overflow_error);
+        CHECK_THROWS_AS(Fraction::approximate(std::nan("")), std::invalid_argument);
+        CHECK_THROWS_AS(Fraction::approximate(0.5, 0), std::invalid_argument);
+    }
+
+    TEST_CASE("Exact conversion and to_double") {
+        CHECK_EQ(Fraction::exactFromDouble(0.375), Fraction(3, 8));
+        CHECK_EQ(Fraction::exactFromDouble(-1536.0), Fraction(-1536, 1));
+        CHECK_EQ(Fraction::exactFromDouble(0.0), Fraction(0, 1));
+        CHECK_THROWS_AS(Fraction::exactFromDouble(0.1), std::overflow_error);
+        CHECK_THROWS_AS(Fraction::exactFromDouble(1e10), std::overflow_error);
+        CHECK_EQ(Fraction(1, 3).to_double(), 1.0 / 3.0);
+        CHECK_EQ(Fraction(-3, 8).to_double(), -0.375);
+        CHECK_EQ(Fraction(7, 1).to_double(), 7.0);
+        CHECK_EQ(Fraction::exactFromDouble(Fraction(5, 1024).to_double()), Fraction(5, 1024));
+    }
+}
+
+TEST_SUITE("Floating-point export") {
+    TEST_CASE("to_float is correctly rounded") {
+        size_t mismatches = 0;
+        uint32_t state = 12345;
+        for (int i = 0; i < 20000; ++i) {
+            state = state * 1664525U + 1013904223U;
+            int numerator = static_cast<int>(state >> 1U) - (1 << 30);
+            state = state * 1664525U + 1013904223U;
+            int denominator = static_cast<int>(state >> (1U + state % 24U)) + 1;
+            Fraction fraction(numerator, denominator);
+            // A 64-bit long double quotient narrows correctly unless it is exactly halfway between two floats.
+            long double quotient = static_cast<long double>(fraction.getNumerator()) / fraction.getDenominator();
+            float below = nextafterf(static_cast<float>(quotient), 0.0f);
+            if (static_cast<long double>(below) + (static_cast<long double>(static_cast<float>(quotient)) - below) / 2 == quotient) continue;
+            if (fraction.to_float() != static_cast<float>(quotient)) ++mismatches;
+        }
+        CHECK_EQ(mismatches, 0);
+        CHECK_EQ(Fraction(16777217, 16777216).to_float(), 1.0f);
+        CHECK_EQ(Fraction(16777219, 16777216).to_float(), 1.0f + 0x1p-22f);
+        CHECK_EQ(Fraction(-16777219, 8388608).to_float(), -2.0f - 0x1p-21f);
+        CHECK_EQ(Fraction(1, 3).to_float(), 1.0f / 3.0f);
+        CHECK_EQ(Fraction(0, 1).to_float(), 0.0f);
+    }
+
+    TEST_CASE("Batch conversions match the scalar ones") {
+        vector<Fraction> fractions;
+        for (int i = 1; i <= 999; ++i) fractions.emplace_back(i * 7919 - 3000000, i);
+        vector<double> doubles(fractions.size());
+        vector<float> floats(fractions.size());
+        Fraction::toDoubles(fractions.data(), fractions.size(), doubles.data());
+        Fraction::toFloats(fractions.data(), fractions.size(), floats.data());
+        size_t mismatches = 0;
+        for (size_t i = 0; i < fractions.size(); ++i) {
+            if (doubles[i] != fractions[i].to_double() || floats[i] != fractions[i].to_float()) ++mismatches;
+        }
+        CHECK_EQ(mismatches, 0);
+    }
+}
+
+/**
+ * A BigInt of about limbs 32-bit limbs with pseudo-random digits and the given sign.
+ */
+static BigInt randomBigInt(mt19937_64 &random, size_t limbs, bool negative) {
+    BigInt value = 0;
+    for (size_t i = 0; i < limbs; ++i) {
+        value = value * BigInt(int64_t{1} << 32) + BigInt(static_cast<int64_t>(random() >> 32U));
+    }
+    return negative ? -value : value;
+}
+
+TEST_SUITE("BigInt") {
+    TEST_CASE("Small values stay inline and spill on overflow") {
+        BigInt max = numeric_limits<int64_t>::max();
+        CHECK(max.isSmall());
+        BigInt sum = max + 1;
+        CHECK_FALSE(sum.isSmall());
+        CHECK_EQ(sum.toString(), "9223372036854775808");
+        CHECK((sum - 1).isSmall());
+        CHECK_EQ(sum - 1, max);
+        CHECK(BigInt(numeric_limits<int64_t>::min()).isSmall());
+        CHECK_EQ((-BigInt(numeric_limits<int64_t>::min())).toString(), "9223372036854775808");
+        CHECK_THROWS_AS(static_cast<void>(sum.toInt64()), std::overflow_error);
+
+        BigInt power = 1;
+        for (int i = 0; i < 100; ++i) power *= 2;
+        CHECK_EQ(power.toString(), "1267650600228229401496703205376");
+        CHECK_EQ(power.bitLength(), 101);
+        CHECK_EQ((-power).toString(), "-1267650600228229401496703205376");
+        CHECK_EQ(BigInt(-42).toString(), "-42");
+    }
+
+    TEST_CASE("Arithmetic identities on multi-limb values") {
+        mt19937_64 random(7);
+        size_t mismatches = 0;
+        for (int i = 0; i < 300; ++i) {
+            BigInt a = randomBigInt(random, 1 + random() % 12, random() % 2 == 0);
+            BigInt b = randomBigInt(random, 1 + random() % 8, random() % 2 == 0);
+            if (b.isZero()) continue;
+            BigInt quotient;
+            BigInt remainder;
+            BigInt::divMod(a, b, quotient, remainder);
+            if (quotient * b + remainder != a) ++mismatches;
+            if (remainder.abs() >= b.abs()) ++mismatches;
+            if (!remainder.isZero() && remainder.sign() != a.sign()) ++mismatches;
+            if ((a * b) / b != a || (a * b) % b != 0) ++mismatches;
+            if ((a + b) - b != a || a - a != 0) ++mismatches;
+            if ((a < b) != ((a - b).sign() < 0)) ++mismatches;
+            BigInt gcd = BigInt::gcd(a * 6, b * 4);
+            if ((a * 6) % gcd != 0 || (b * 4) % gcd != 0 || gcd % 2 != 0) ++mismatches;
+        }
+        CHECK_EQ(mismatches, 0);
+        CHECK_THROWS_AS(BigInt(1) / BigInt(0), std::runtime_error);
+    }
+
+    TEST_CASE("Karatsuba and Toom-3 products match schoolbook products") {
+        mt19937_64 random(11);
+        vector<pair<BigInt, BigInt>> operands;
+        for (size_t limbs : {size_t{9}, size_t{16}, size_t{33}, size_t{70}, size_t{151}}) {
+            operands.emplace_back(randomBigInt(random, limbs, false), randomBigInt(random, limbs, true));
+            operands.emplace_back(randomBigInt(random, limbs, true), randomBigInt(random, limbs / 2 + 3, true));
+            operands.emplace_back(randomBigInt(random, limbs * 3, false), randomBigInt(random, limbs, false));
+        }
+        BigInt allOnes = BigInt(1);
+        for (int i = 0; i < 64; ++i) allOnes *= BigInt(int64_t{1} << 32);
+        operands.emplace_back(allOnes - 1, allOnes - 1);
+
+        size_t defaultKaratsuba = BigInt::karatsubaThreshold();
+        size_t defaultToom3 = BigInt::toom3Threshold();
+        vector<BigInt> schoolbook;
+        BigInt::setMultiplyThresholds(numeric_limits<size_t>::max(), numeric_limits<size_t>::max());
+        for (const auto &[a, b] : operands) schoolbook.push_back(a * b);
+        BigInt::setMultiplyThresholds(4, numeric_limits<size_t>::max());
+        vector<BigInt> karatsuba;
+        for (const auto &[a, b] : operands) karatsuba.push_back(a * b);
+        BigInt::setMultiplyThresholds(4, 9);
+        vector<BigInt> toom3;
+        for (const auto &[a, b] : operands) toom3.push_back(a * b);
+        BigInt::setMultiplyThresholds(defaultKaratsuba, defaultToom3);
+
+        size_t mismatches = 0;
+        for (size_t i = 0; i < operands.size(); ++i) {
+            if (karatsuba[i] != schoolbook[i] || toom3[i] != schoolbook[i]) ++mismatches;
+            if (!operands[i].second.isZero() && schoolbook[i] / operands[i].second != operands[i].first) ++mismatches;
+        }
+        CHECK_EQ(mismatches, 0);
+        CHECK_EQ(BigInt::karatsubaThreshold(), BigInt::DEFAULT_KARATSUBA_THRESHOLD);
+    }
+
+    TEST_CASE("Lehmer and half-gcd agree with Euclid") {
+        mt19937_64 random(13);
+        size_t mismatches = 0;
+        for (size_t halfGcd : {BigInt::DEFAULT_HALF_GCD_THRESHOLD, size_t{4}}) {
+            BigInt::setHalfGcdThreshold(halfGcd);
+            for (int i = 0; i < 40; ++i) {
+                BigInt common = randomBigInt(random, 1 + random() % 40, false);
+                BigInt a = common * randomBigInt(random, 1 + random() % 120, random() % 2 == 0);
+                BigInt b = common * randomBigInt(random, 1 + random() % 120, random() % 2 == 0);
+                BigInt x = a.abs();
+                BigInt y = b.abs();
+                while (!y.isZero()) {
+                    BigInt rest = x % y;
+                    x = std::move(y);
+                    y = std::move(rest);
+                }
+                BigInt gcd = BigInt::gcd(a, b);
+                if (gcd != x || BigInt::gcd(b, a) != x) ++mismatches;
+            }
+        }
+        BigInt::setHalfGcdThreshold(BigInt::DEFAULT_HALF_GCD_THRESHOLD);
+        CHECK_EQ(mismatches, 0);
+
+        BigInt fibonacci = 0;
+        BigInt next = 1;
+        for (int i = 0; i < 3000; ++i) {
+            BigInt sum = fibonacci + next;
+            fibonacci = std::move(next);
+            next = std::move(sum);
+        }
+        CHECK_EQ(BigInt::gcd(next, fibonacci), 1);
+        CHECK_EQ(BigInt::gcd(next * 5, fibonacci * 35), 5);
+        CHECK_EQ(BigInt::gcd(next, 0), next);
+    }
+}
+
+TEST_SUITE("BigFraction") {
+    TEST_CASE("Sums that overflow Fraction stay exact") {
+        Fraction big(numeric_limits<int>::max(), 1);
+        CHECK_THROWS_AS(big + big, std::overflow_error);
+        BigFraction sum = BigFraction(big) + big;
+        CHECK_EQ(sum.toString(), "4294967294/1");
+        CHECK_FALSE(sum.fitsFraction());
+        CHECK_THROWS_AS(static_cast<void>(sum.toFraction()), std::overflow_error);
+        CHECK_EQ((sum - big).toFraction(), big);
+
+        CHECK_THROWS_AS(big * big, std::overflow_error);
+        BigFraction product = BigFraction(big) * big / Fraction(6, 1);
+        CHECK_EQ(product.toString(), "4611686014132420609/6");
+    }
+
+    TEST_CASE("Results are reduced and match Fraction where it does not overflow") {
+        size_t mismatches = 0;
+        for (int a = -6; a <= 6; ++a) {
+            for (int b = 1; b <= 6; ++b) {
+                for (int c = -6; c <= 6; ++c) {
+                    for (int d = 1; d <= 6; ++d) {
+                        Fraction x(a, b);
+                        Fraction y(c, d);
+                        BigFraction bx(x);
+                        BigFraction by(y);
+                        if ((bx + by).toFraction() != x + y || (bx - by).toFraction() != x - y) ++mismatches;
+                        if ((bx * by).toFraction() != x * y) ++mismatches;
+                        if (c != 0 && (bx / by).toFraction() != x / y) ++mismatches;
+                        if ((bx < by) != (x.to_double() < y.to_double()) || (bx == by) != (x == y)) ++mismatches;
+                    }
+                }
+            }
+        }
+        CHECK_EQ(mismatches, 0);
+        CHECK_EQ(BigFraction(BigInt(6), BigInt(-4)).toString(), "-3/2");
+        CHECK_THROWS_AS(BigFraction(BigInt(1), BigInt(0)), std::invalid_argument);
+        CHECK_THROWS_AS(BigFraction(1) / BigFraction(), std::runtime_error);
+
+        Fraction read;
+        Fraction zero;
+        istringstream("2/4 0/5") >> read >> zero;
+        CHECK_EQ(BigFraction(read), BigFraction(Fraction(1, 2)));
+        CHECK_EQ(BigFraction(read).toString(), "1/2");
+        CHECK_EQ(BigFraction(zero), BigFraction());
+    }
+
+    TEST_CASE("Harmonic sums grow past 64 bits") {
+        BigFraction harmonic;
+        for (int i = 1; i <= 60; ++i) harmonic += Fraction(1, i);
+        CHECK_FALSE(harmonic.getDenominator().isSmall());
+        CHECK_EQ(harmonic.toString(), "15117092380124150817026911/3230237388259077233637600");
+    }
+}
+
+TEST_SUITE("AdaptiveFraction") {
+    TEST_CASE("Products that overflow Fraction widen and narrow back") {
+        Fraction big(999999, 1000000);
+        CHECK_THROWS_AS(big * big * big * big, std::overflow_error);
+
+        using Width = AdaptiveFraction::Width;
+        AdaptiveFraction power = big;
+        CHECK_EQ(power.getWidth(), Width::Narrow);
+        power *= big;
+        CHECK_EQ(power.getWidth(), Width::Wide);
+        CHECK_EQ(power.toString(), "999998000001/1000000000000");
+        CHECK_THROWS_AS(static_cast<void>(power.toFraction()), std::overflow_error);
+        power *= power;
+        CHECK_EQ(power.getWidth(), Width::Big);
+        CHECK_EQ(power.toBigFraction(), BigFraction(big) * big * big * big);
+        for (int i = 0; i < 4; ++i) power /= big;
+        CHECK_EQ(power.getWidth(), Width::Narrow);
+        CHECK_EQ(power.toFraction(), Fraction(1, 1));
+        CHECK_EQ(power, AdaptiveFraction(1));
+    }
+
+    TEST_CASE("Fractions read unreduced convert reduced") {
+        Fraction read;
+        Fraction zero;
+        istringstream("2/4 0/5") >> read >> zero;
+        CHECK_EQ(AdaptiveFraction(read), AdaptiveFraction(1, 2));
+        CHECK_EQ(AdaptiveFraction(read).toString(), "1/2");
+        CHECK_EQ(AdaptiveFraction(read) - AdaptiveFraction(Fraction(1, 2)), AdaptiveFraction());
+        CHECK_EQ(AdaptiveFraction(zero), AdaptiveFraction());
+    }
+
+    TEST_CASE("Results match Fraction where it does not overflow") {
+        size_t mismatches = 0;
+        for (int a = -6; a <= 6; ++a) {
+            for (int b = 1; b <= 6; ++b) {
+                for (int c = -6; c <= 6; ++c) {
+                    for (int d = 1; d <= 6; ++d) {
+                        Fraction x(a, b);
+                        Fraction y(c, d);
+                        AdaptiveFraction ax(x);
+                        AdaptiveFraction ay(y);
+                        if ((ax + ay).toFraction() != x + y || (ax - ay).toFraction() != x - y) ++mismatches;
+                        if ((ax * ay).toFraction() != x * y) ++mismatches;
+                        if (c != 0 && (ax / ay).toFraction() != x / y) ++mismatches;
+                        if ((ax < ay) != (x.to_double() < y.to_double()) || (ax == ay) != (x == y)) ++mismatches;
+                    }
+                }
+            }
+        }
+        CHECK_EQ(mismatches, 0);
+        CHECK_EQ(AdaptiveFraction(6, -4).toString(), "-3/2");
+        CHECK_THROWS_AS(AdaptiveFraction(1, 0), std::invalid_argument);
+        CHECK_THROWS_AS(AdaptiveFraction(1) / AdaptiveFraction(), std::runtime_error);
+    }
+
+    TEST_CASE("Width boundaries") {
+        using Width = AdaptiveFraction::Width;
+        AdaptiveFraction intMin = numeric_limits<int>::min();
+        CHECK_EQ(intMin.getWidth(), Width::Narrow);
+        CHECK_EQ((-intMin).getWidth(), Width::Wide);
+        CHECK_EQ((-intMin).toString(), "2147483648/1");
+        CHECK_EQ((-(-intMin)).getWidth(), Width::Narrow);
+        CHECK_EQ(AdaptiveFraction(1, intMin.toFraction().getNumerator()).getWidth(), Width::Wide);
+
+        AdaptiveFraction int64Min = numeric_limits<int64_t>::min();
+        CHECK_EQ(int64Min.getWidth(), Width::Wide);
+        CHECK_EQ((-int64Min).getWidth(), Width::Big);
+        CHECK_EQ((-int64Min).toString(), "9223372036854775808/1");
+        CHECK_EQ(-int64Min - 1, AdaptiveFraction(numeric_limits<int64_t>::max()));
+        CHECK_EQ((-int64Min - 1).getWidth(), Width::Wide);
+
+        AdaptiveFraction tiny(1, numeric_limits<int64_t>::max());
+        CHECK(tiny > AdaptiveFraction());
+        CHECK(tiny * tiny < tiny);
+        CHECK((tiny * tiny).getWidth() == Width::Big);
+        CHECK_EQ((tiny * tiny) / tiny, tiny);
+        CHECK_EQ(tiny + tiny - tiny, tiny);
+    }
+}
+
+/**
+ * The n x n Hilbert matrix, whose entries are 1/(i + j + 1).
+ */
+static FractionMatrix hilbert(size_t n) {
+    FractionMatrix matrix(n, n);
+    for (size_t i = 0; i < n; ++i) {
+        for (size_t j = 0; j < n; ++j) matrix(i, j) = Fraction(1, static_cast<int>(i + j + 1));
+    }
+    return matrix;
+}
+
+TEST_SUITE("FractionMatrix") {
+    TEST_CASE("Determinant and inverse of Hilbert matrices") {
+        CHECK_EQ(hilbert(4).determinant().toString(), "1/6048000");
+        CHECK_EQ(hilbert(5).determinant().toString(), "1/266716800000");
+        FractionMatrix inverse{{16,   -120, 240,   -140},
+                               {-120, 1200, -2700, 1680},
+                               {240,  -2700, 6480, -4200},
+                               {-140, 1680, -4200, 2800}};
+        CHECK_EQ(hilbert(4).inverse(), inverse);
+        CHECK_EQ(inverse.inverse(), hilbert(4));
+        CHECK_EQ(FractionMatrix().determinant(), BigFraction(1));
+
+        FractionMatrix swapped{{0, 1}, {1, 0}};
+        CHECK_EQ(swapped.determinant(), BigFraction(-1));
+        CHECK_EQ(swapped.inverse(), swapped);
+    }
+
+    TEST_CASE("Solutions satisfy the system") {
+        mt19937 random(5);
+        uniform_int_distribution<int> numerators(-9, 9);
+        uniform_int_distribution<int> denominators(1, 9);
+        size_t mismatches = 0;
+        for (size_t n = 1; n <= 8; ++n) {
+            FractionMatrix matrix(n, n);
+            vector<Fraction> rhs(n);
+            for (size_t i = 0; i < n; ++i) {
+                for (size_t j = 0; j < n; ++j) matrix(i, j) = Fraction(numerators(random), denominators(random));
+                rhs[i] = Fraction(numerators(random), denominators(random));
+            }
+            if (matrix.determinant() == BigFraction()) continue;
+            vector<BigFraction> solution = matrix.solve(rhs);
+            for (size_t i = 0; i < n; ++i) {
+                BigFraction sum;
+                for (size_t j = 0; j < n; ++j) sum += BigFraction(matrix(i, j)) * solution[j];
+                if (sum != BigFraction(rhs[i])) ++mismatches;
+            }
+        }
+        CHECK_EQ(mismatches, 0);
+    }
+
+    TEST_CASE("Rank and singular matrices") {
+        FractionMatrix singular{{1, 2, 3}, {Fraction(1, 2), 1, Fraction(3, 2)}, {1, 0, 1}};
+        CHECK_EQ(singular.rank(), 2);
+        CHECK_EQ(singular.determinant(), BigFraction());
+        CHECK_THROWS_AS(static_cast<void>(singular.solve({1, 2, 3})), std::runtime_error);
+        CHECK_THROWS_AS(static_cast<void>(singular.inverse()), std::runtime_error);
+
+        FractionMatrix wide{{0, 0, 1, 2}, {0, 0, 2, 4}, {0, 1, 0, 0}};
+        CHECK_EQ(wide.rank(), 2);
+        CHECK_EQ(FractionMatrix(3, 3).rank(), 0);
+        CHECK_EQ(FractionMatrix::identity(5).rank(), 5);
+        CHECK_THROWS_AS(static_cast<void>(wide.determinant()), std::invalid_argument);
+        CHECK_THROWS_AS(static_cast<void>(FractionMatrix::identity(2).solve({1})), std::invalid_argument);
+        CHECK_THROWS_AS((FractionMatrix{{1, 2}, {3}}), std::invalid_argument);
+    }
+
+    TEST_CASE("Products match BigFraction dot products") {
+        mt19937 random(11);
+        uniform_int_distribution<int> numerators(-9, 9);
+        uniform_int_distribution<int> denominators(1, 6);
+        FractionMatrix left(45, 300);
+        FractionMatrix right(300, 37);
+        for (size_t i = 0; i < 45 * 300; ++i) left.data()[i] = Fraction(numerators(random), denominators(random));
+        for (size_t i = 0; i < 300 * 37; ++i) right.data()[i] = Fraction(numerators(random), denominators(random));
+        FractionMatrix product = FractionMatrix::multiply(left, right, 1);
+        CHECK_EQ(product.rows(), 45);
+        CHECK_EQ(product.columns(), 37);
+        size_t mismatches = 0;
+        for (size_t i = 0; i < 45; ++i) {
+            for (size_t j = 0; j < 37; ++j) {
+                BigFraction sum;
+                for (size_t k = 0; k < 300; ++k) sum += BigFraction(left(i, k)) * BigFraction(right(k, j));
+                if (BigFraction(product(i, j)) != sum) ++mismatches;
+            }
+        }
+        CHECK_EQ(mismatches, 0);
+        CHECK_EQ(FractionMatrix::multiply(left, right, 4), product);
+        CHECK_EQ(hilbert(4) * hilbert(4).inverse(), FractionMatrix::identity(4));
+    }
+
+    TEST_CASE("Products beyond 64-bit scales and overflowing products") {
+        FractionMatrix row{{Fraction(1, 2147483647), Fraction(1, 2147483629), Fraction(1, 2147483587)}};
+        FractionMatrix column{{Fraction(2147483647, 1)}, {Fraction(2147483629, 1)}, {Fraction(2147483587, 1)}};
+        CHECK_EQ(row * column, FractionMatrix{{3}});
+        FractionMatrix big{{Fraction(numeric_limits<int>::max(), 1)}};
+        CHECK_THROWS_AS(static_cast<void>(big * big), std::overflow_error);
+        CHECK_THROWS_AS(static_cast<void>(row * row), std::invalid_argument);
+    }
+
+    TEST_CASE("Multi-modular determinant and solve match Bareiss") {
+        mt19937 random(17);
+        uniform_int_distribution<int> numerators(-1000, 1000);
+        uniform_int_distribution<int> denominators(1, 1000);
+        size_t mismatches = 0;
+        for (size_t n = 1; n <= 12; ++n) {
+            FractionMatrix matrix(n, n);
+            vector<Fraction> rhs(n);
+            for (size_t i = 0; i < n; ++i) {
+                for (size_t j = 0; j < n; ++j) matrix(i, j) = Fraction(numerators(random), denominators(random));
+                rhs[i] = Fraction(numerators(random), denominators(random));
+            }
+            if (matrix.modularDeterminant(static_cast<unsigned>(n % 3 + 1)) != matrix.determinant()) ++mismatches;
+            if (matrix.modularSolve(rhs, static_cast<unsigned>(n % 4 + 1)) != matrix.solve(rhs)) ++mismatches;
+        }
+        CHECK_EQ(mismatches, 0);
+        CHECK_EQ(hilbert(10).modularDeterminant(), hilbert(10).determinant());
+        vector<Fraction> ones(10, Fraction(1, 1));
+        CHECK_EQ(hilbert(10).modularSolve(ones), hilbert(10).solve(ones));
+        CHECK_EQ(FractionMatrix().modularDeterminant(), BigFraction(1));
+    }
+
+    TEST_CASE("Multi-modular methods on singular and mismatched systems") {
+        FractionMatrix singular{{1, 2, 3}, {Fraction(1, 2), 1, Fraction(3, 2)}, {1, 0, 1}};
+        CHECK_EQ(singular.modularDeterminant(), BigFraction());
+        CHECK_THROWS_AS(static_cast<void>(singular.modularSolve({1, 2, 3})), std::runtime_error);
+        CHECK_THROWS_AS(static_cast<void>(FractionMatrix(2, 3).modularDeterminant()), std::invalid_argument);
+        CHECK_THROWS_AS(static_cast<void>(FractionMatrix::identity(2).modularSolve({1})), std::invalid_argument);
+        FractionMatrix swapped{{0, Fraction(1, 3)}, {-2, 0}};
+        CHECK_EQ(swapped.modularDeterminant(), BigFraction(Fraction(2, 3)));
+
+        // 2^31 - 1 is the first modulus tried; a denominator it divides makes it unusable.
+        FractionMatrix prime{{Fraction(1, 2147483647), 1}, {1, Fraction(2, 2147483629)}};
+        CHECK_EQ(prime.modularDeterminant(), prime.determinant());
+        CHECK_EQ(prime.modularSolve({1, Fraction(1, 2147483647)}), prime.solve({1, Fraction(1, 2147483647)}));
+    }
+}
+
+/**
+ * @return Whether every constraint of the program holds at values.
+ */
+static bool feasible(const vector<vector<pair<size_t, Fraction>>> &rows, const vector<LinearProgram::Relation> &relations,
+                     const vector<Fraction> &bounds, const vector<BigFraction> &values) {
+    for (size_t row = 0; row < rows.size(); ++row) {
+        BigFraction sum;
+        for (const auto &[variable, coefficient]: rows[row]) sum += BigFraction(coefficient) * values[variable];
+        int order = BigFraction::compare(sum, BigFraction(bounds[row]));
+        if (relations[row] == LinearProgram::Relation::LessEqual && order > 0) return false;
+        if (relations[row] == LinearProgram::Relation::GreaterEqual && order < 0) return false;
+        if (relations[row] == LinearProgram::Relation::Equal && order != 0) return false;
+    }
+    for (const BigFraction &value: values) {
+        if (value < BigFraction()) return false;
+    }
+    return true;
+}
+
+TEST_SUITE("LinearProgram") {
+    using Relation = LinearProgram::Relation;
+    using Status = LinearProgram::Status;
+
+    TEST_CASE("Optimal solutions are exact") {
+        LinearProgram program(2);
+        program.setObjective(0, 3);
+        program.setObjective(1, 5);
+        program.addConstraint({{0, 1}}, Relation::LessEqual, 4);
+        program.addConstraint({{1, 2}}, Relation::LessEqual, 12);
+        program.addConstraint({{0, 3}, {1, 2}}, Relation::LessEqual, 18);
+        LinearProgram::Solution solution = program.maximize();
+        CHECK_EQ(solution.status, Status::Optimal);
+        CHECK_EQ(solution.objective, BigFraction(36));
+        CHECK_EQ(solution.values, vector<BigFraction>{BigFraction(2), BigFraction(6)});
+
+        LinearProgram quarters(2);
+        quarters.setObjective(0, 1);
+        quarters.setObjective(1, 1);
+        quarters.addConstraint({{0, 3}, {1, 1}}, Relation::LessEqual, 1);
+        quarters.addConstraint({{0, 1}, {1, 3}}, Relation::LessEqual, 1);
+        solution = quarters.maximize();
+        CHECK_EQ(solution.objective, BigFraction(Fraction(1, 2)));
+        CHECK_EQ(solution.values[0], BigFraction(Fraction(1, 4)));
+    }
+
+    TEST_CASE("Minimization with equality and lower-bound constraints") {
+        LinearProgram program(2);
+        program.setObjective(0, 2);
+        program.setObjective(1, 3);
+        program.addConstraint({{0, 1}, {1, 1}}, Relation::GreaterEqual, 4);
+        program.addConstraint({{0, 1}, {1, -1}}, Relation::Equal, 1);
+        LinearProgram::Solution solution = program.minimize();
+        CHECK_EQ(solution.status, Status::Optimal);
+        CHECK_EQ(solution.objective, BigFraction(Fraction(19, 2)));
+        CHECK_EQ(solution.values, vector<BigFraction>{BigFraction(Fraction(5, 2)), BigFraction(Fraction(3, 2))});
+
+        // The second equality repeats the first, so an artificial variable stays basic at zero.
+        LinearProgram redundant(2);
+        redundant.setObjective(0, 1);
+        redundant.addConstraint({{0, 1}, {1, 1}}, Relation::Equal, 2);
+        redundant.addConstraint({{0, 2}, {1, 2}}, Relation::Equal, 4);
+        solution = redundant.maximize();
+        CHECK_EQ(solution.status, Status::Optimal);
+        CHECK_EQ(solution.objective, BigFraction(2));
+    }
+
+    TEST_CASE("Infeasible and unbounded programs") {
+        LinearProgram infeasible(1);
+        infeasible.addConstraint({{0, 1}}, Relation::GreaterEqual, 2);
+        infeasible.addConstraint({{0, 1}}, Relation::LessEqual, 1);
+        CHECK_EQ(infeasible.maximize().status, Status::Infeasible);
+
+        LinearProgram unbounded(2);
+        unbounded.setObjective(0, 1);
+        unbounded.addConstraint({{0, 1}, {1, -1}}, Relation::LessEqual, 1);
+        CHECK_EQ(unbounded.maximize().status, Status::Unbounded);
+        CHECK_EQ(unbounded.minimize().status, Status::Optimal);
+
+        CHECK_THROWS_AS(unbounded.setObjective(2, 1), std::invalid_argument);
+        CHECK_THROWS_AS(unbounded.addConstraint({{5, 1}}, Relation::Equal, 0), std::invalid_argument);
+    }
+
+    TEST_CASE("Bland's rule terminates on Beale's cycling example") {
+        LinearProgram program(4);
+        program.setObjective(0, Fraction(-3, 4));
+        program.setObjective(1, 20);
+        program.setObjective(2, Fraction(-1, 2));
+        program.setObjective(3, 6);
+        program.addConstraint({{0, Fraction(1, 4)}, {1, -8}, {2, -1}, {3, 9}}, Relation::LessEqual, 0);
+        program.addConstraint({{0, Fraction(1, 2)}, {1, -12}, {2, Fraction(-1, 2)}, {3, 3}}, Relation::LessEqual, 0);
+        program.addConstraint({{2, 1}}, Relation::LessEqual, 1);
+        LinearProgram::Solution solution = program.minimize();
+        CHECK_EQ(solution.status, Status::Optimal);
+        CHECK_EQ(solution.objective, BigFraction(Fraction(-5, 4)));
+    }
+
+    TEST_CASE("Coefficients beyond int do not overflow") {
+        int big = numeric_limits<int>::max();
+        LinearProgram program(2);
+        program.setObjective(0, Fraction(big, 1));
+        program.setObjective(1, Fraction(big - 1, 1));
+        program.addConstraint({{0, Fraction(big, big - 2)}, {1, Fraction(big - 1, big - 4)}}, Relation::LessEqual,
+                              Fraction(1, big));
+        program.addConstraint({{0, Fraction(big - 4, 3)}, {1, Fraction(1, big)}}, Relation::LessEqual, 1);
+        LinearProgram::Solution solution = program.maximize();
+        CHECK_EQ(solution.status, Status::Optimal);
+        CHECK(feasible({{{0, Fraction(big, big - 2)}, {1, Fraction(big - 1, big - 4)}},
+                        {{0, Fraction(big - 4, 3)}, {1, Fraction(1, big)}}},
+                       {Relation::LessEqual, Relation::LessEqual}, {Fraction(1, big), 1}, solution.values));
+        CHECK_GT(solution.objective, BigFraction());
+    }
+
+    TEST_CASE("Random programs reach feasible optima") {
+        mt19937 random(23);
+        uniform_int_distribution<int> numerators(-9, 9);
+        uniform_int_distribution<int> denominators(1, 9);
+        size_t failures = 0;
+        for (size_t trial = 0; trial < 20; ++trial) {
+            size_t variables = 3 + trial % 5;
+            LinearProgram program(variables);
+            vector<vector<pair<size_t, Fraction>>> rows;
+            vector<Relation> relations;
+            vector<Fraction> bounds;
+            for (size_t variable = 0; variable < variables; ++variable) {
+                program.setObjective(variable, Fraction(numerators(random), denominators(random)));
+                // A box keeps every program bounded.
+                rows.push_back({{variable, 1}});
+                relations.push_back(Relation::LessEqual);
+                bounds.emplace_back(abs(numerators(random)) + 1, denominators(random));
+            }
+            for (size_t row = 0; row < variables; ++row) {
+                vector<pair<size_t, Fraction>> terms;
+                for (size_t variable = 0; variable < variables; ++variable) {
+                    terms.emplace_back(variable, Fraction(numerators(random), denominators(random)));
+                }
+                rows.push_back(terms);
+                relations.push_back(row % 3 == 0 ? Relation::GreaterEqual : Relation::LessEqual);
+                bounds.emplace_back(numerators(random), denominators(random));
+            }
+            for (size_t row = 0; row < rows.size(); ++row) program.addConstraint(rows[row], relations[row], bounds[row]);
+            LinearProgram::Solution solution = program.maximize();
+            if (solution.status == Status::Unbounded) ++failures;
+            if (solution.status == Status::Optimal && !feasible(rows, relations, bounds, solution.values)) ++failures;
+        }
+        CHECK_EQ(failures, 0);
+    }
+}
+
+/**
+ * @return The polynomial with random coefficients of the given degree, from numerators and denominators up to bound.
+ */
+static RationalPolynomial randomPolynomial(mt19937 &random, size_t degree, int bound) {
+    uniform_int_distribution<int> numerators(-bound, bound);
+    uniform_int_distribution<int> denominators(1, bound);
+    vector<Fraction> coefficients;
+    for (size_t i = 0; i <= degree; ++i) coefficients.emplace_back(numerators(random), denominators(random));
+    return RationalPolynomial(coefficients);
+}
+
+/**
+ * Horner's method on BigFractions, reducing after every step.
+ */
+static BigFraction hornerReference(const RationalPolynomial &polynomial, const Fraction &point) {
+    BigFraction value;
+    for (size_t power = polynomial.degree() + 1; power-- > 0;) value = value * point + polynomial.coefficient(power);
+    return value;
+}
+
+TEST_SUITE("RationalPolynomial") {
+    TEST_CASE("Canonical form and coefficients") {
+        RationalPolynomial polynomial{Fraction(1, 4), Fraction(-3, 1), Fraction(1, 2), 0};
+        CHECK_EQ(polynomial.degree(), 2);
+        CHECK_EQ(polynomial.coefficient(0), BigFraction(Fraction(1, 4)));
+        CHECK_EQ(polynomial.coefficient(1), BigFraction(-3));
+        CHECK_EQ(polynomial.coefficient(5), BigFraction());
+        CHECK_EQ(polynomial.toString(), "1/2*x^2 + -3/1*x + 1/4");
+        CHECK_EQ(polynomial, (RationalPolynomial{Fraction(2, 8), Fraction(-6, 2), Fraction(3, 6)}));
+        CHECK(RationalPolynomial().isZero());
+        CHECK_EQ(RationalPolynomial({0, 0}), RationalPolynomial());
+        CHECK_EQ(RationalPolynomial().toString(), "0");
+        CHECK_EQ(polynomial - polynomial, RationalPolynomial());
+    }
+
+    TEST_CASE("Evaluation matches Horner's method on BigFractions") {
+        mt19937 random(29);
+        uniform_int_distribution<int> numerators(-20, 20);
+        uniform_int_distribution<int> denominators(1, 20);
+        size_t mismatches = 0;
+        for (size_t degree = 0; degree <= 24; ++degree) {
+            RationalPolynomial polynomial = randomPolynomial(random, degree, 50);
+            vector<Fraction> points;
+            for (size_t i = 0; i < 8; ++i) points.emplace_back(numerators(random), denominators(random));
+            points.emplace_back(numeric_limits<int>::max(), 3);
+            vector<BigFraction> values(points.size());
+            polynomial.evaluate(points.data(), points.size(), values.data());
+            for (size_t i = 0; i < points.size(); ++i) {
+                BigFraction expected = hornerReference(polynomial, points[i]);
+                if (polynomial.evaluate(points[i]) != expected || values[i] != expected) ++mismatches;
+            }
+        }
+        CHECK_EQ(mismatches, 0);
+        CHECK_EQ(RationalPolynomial().evaluate(Fraction(3, 7)), BigFraction());
+    }
+
+    TEST_CASE("Sums and products agree with pointwise values") {
+        mt19937 random(31);
+        size_t mismatches = 0;
+        for (size_t trial = 0; trial < 20; ++trial) {
+            RationalPolynomial left = randomPolynomial(random, trial % 7, 30);
+            RationalPolynomial right = randomPolynomial(random, trial % 5, 30);
+            for (const Fraction &point: {Fraction(2, 3), Fraction(-5, 7), Fraction(11, 1)}) {
+                BigFraction a = left.evaluate(point);
+                BigFraction b = right.evaluate(point);
+                if ((left + right).evaluate(point) != a + b) ++mismatches;
+                if ((left - right).evaluate(point) != a - b) ++mismatches;
+                if ((left * right).evaluate(point) != a * b) ++mismatches;
+            }
+            if ((left * right).degree() != left.degree() + right.degree()) ++mismatches;
+        }
+        CHECK_EQ(mismatches, 0);
+    }
+
+    TEST_CASE("Exact division") {
+        mt19937 random(37);
+        size_t mismatches = 0;
+        for (size_t trial = 0; trial < 20; ++trial) {
+            RationalPolynomial dividend = randomPolynomial(random, 4 + trial % 6, 40);
+            RationalPolynomial divisor = randomPolynomial(random, 1 + trial % 4, 40);
+            RationalPolynomial quotient;
+            RationalPolynomial remainder;
+            RationalPolynomial::divMod(dividend, divisor, quotient, remainder);
+            if (quotient * divisor + remainder != dividend) ++mismatches;
+            if (!remainder.isZero() && remainder.degree() >= divisor.degree()) ++mismatches;
+            if ((dividend * divisor) / divisor != dividend || !((dividend * divisor) % divisor).isZero()) ++mismatches;
+        }
+        CHECK_EQ(mismatches, 0);
+
+        RationalPolynomial difference{Fraction(-1, 8), 0, Fraction(1, 2)};
+        RationalPolynomial factor{Fraction(-1, 6), Fraction(1, 3)};
+        CHECK_EQ(difference / factor, (RationalPolynomial{Fraction(3, 4), Fraction(3, 2)}));
+        CHECK(RationalPolynomial(difference % factor).isZero());
+        CHECK_EQ(factor / difference, RationalPolynomial());
+        CHECK_EQ(factor % difference, factor);
+        CHECK_THROWS_AS(static_cast<void>(factor / RationalPolynomial()), std::runtime_error);
+    }
+}
+
+/**
+ * Whether the interval contains the exact value.
+ */
+static bool encloses(const FractionInterval &interval, const BigFraction &value) {
+    return BigFraction(interval.getLower()) <= value && value <= BigFraction(interval.getUpper());
+}
+
+TEST_SUITE("FractionInterval") {
+    TEST_CASE("Endpoints round outward to the nearest bounded Fractions") {
+        FractionInterval third(Fraction(1, 3), 2);
+        CHECK_EQ(third.getLower(), Fraction(0, 1));
+        CHECK_EQ(third.getUpper(), Fraction(1, 2));
+        CHECK_EQ(FractionInterval(Fraction(-1, 3), 2).toString(), "[-1/2, 0/1]");
+        CHECK_EQ(FractionInterval(Fraction(2, 7), 10), FractionInterval(Fraction(2, 7)));
+        CHECK_EQ(FractionInterval(Fraction(1, 3)).toString(), "[1/3, 1/3]");
+        CHECK_EQ(FractionInterval(Fraction(1, 3), Fraction(2, 3), 5).getMaxDenominator(), 5);
+        CHECK_THROWS_AS(FractionInterval(Fraction(1, 2), Fraction(1, 3)), std::invalid_argument);
+        CHECK_THROWS_AS(FractionInterval(Fraction(1, 2), 0), std::invalid_argument);
+
+        // No Fraction with a denominator up to the bound lies strictly between an endpoint and the value.
+        mt19937 random(41);
+        uniform_int_distribution<int> numerators(-100000, 100000);
+        uniform_int_distribution<int> denominators(1, 10000);
+        size_t mismatches = 0;
+        for (size_t trial = 0; trial < 500; ++trial) {
+            Fraction value(numerators(random), denominators(random));
+            int bound = 1 + static_cast<int>(trial % 40);
+            FractionInterval interval(value, bound);
+            std::int64_t n = value.getNumerator();
+            std::int64_t d = value.getDenominator();
+            const Fraction &lower = interval.getLower();
+            const Fraction &upper = interval.getUpper();
+            if (lower.getDenominator() > bound || upper.getDenominator() > bound) ++mismatches;
+            if (!interval.contains(value)) ++mismatches;
+            for (std::int64_t q = 1; q <= bound; ++q) {
+                std::int64_t floor = n * q >= 0 ? n * q / d : -((-n * q + d - 1) / d);
+                std::int64_t ceiling = n * q >= 0 ? (n * q + d - 1) / d : -(-n * q / d);
+                if (floor * lower.getDenominator() > std::int64_t{lower.getNumerator()} * q) ++mismatches;
+                if (ceiling * upper.getDenominator() < std::int64_t{upper.getNumerator()} * q) ++mismatches;
+            }
+        }
+        CHECK_EQ(mismatches, 0);
+    }
+
+    TEST_CASE("Operations contain every exact result") {
+        mt19937 random(43);
+        uniform_int_distribution<int> numerators(-40000, 40000);
+        uniform_int_distribution<int> denominators(1, 40000);
+        size_t mismatches = 0;
+        for (size_t trial = 0; trial < 300; ++trial) {
+            int bound = trial % 2 == 0 ? 1000 : 1 << 16;
+            Fraction a(numerators(random), denominators(random));
+            Fraction b(numerators(random), denominators(random));
+            FractionInterval left(a, bound);
+            FractionInterval right(b, Fraction(b.getNumerator() + 1, b.getDenominator()), bound);
+            vector<pair<FractionInterval, BigFraction (*)(const BigFraction &, const BigFraction &)>> results{
+                    {left + right, [](const BigFraction &x, const BigFraction &y) { return x + y; }},
+                    {left - right, [](const BigFraction &x, const BigFraction &y) { return x - y; }},
+                    {left * right, [](const BigFraction &x, const BigFraction &y) { return x * y; }}};
+            if (!right.contains(Fraction())) {
+                results.emplace_back(left / right, [](const BigFraction &x, const BigFraction &y) { return x / y; });
+            }
+            for (const auto &[result, exact]: results) {
+                if (result.getLower().getDenominator() > bound || result.getUpper().getDenominator() > bound) {
+                    ++mismatches;
+                }
+                for (const Fraction &x: {left.getLower(), left.getUpper()}) {
+                    for (const Fraction &y: {right.getLower(), right.getUpper()}) {
+                        if (!encloses(result, exact(x, y))) ++mismatches;
+                    }
+                }
+                if (!encloses(result, exact(a, b))) ++mismatches;
+            }
+            if ((-left).getLower() != Fraction::fromReduced(-left.getUpper().getNumerator(),
+                                                           left.getUpper().getDenominator())) {
+                ++mismatches;
+            }
+        }
+        CHECK_EQ(mismatches, 0);
+    }
+
+    TEST_CASE("Bounded iterations stay certified") {
+        // The logistic map x -> 7/2 x (1 - x), whose exact iterates double their digits every step.
+        FractionInterval x(Fraction(1, 3), 1 << 16);
+        BigFraction exact = Fraction(1, 3);
+        size_t mismatches = 0;
+        for (size_t step = 0; step < 12; ++step) {
+            x = Fraction(7, 2) * x * (Fraction(1, 1) - x);
+            exact = BigFraction(Fraction(7, 2)) * exact * (BigFraction(1) - exact);
+            if (!encloses(x, exact) || x.getMaxDenominator() != 1 << 16) ++mismatches;
+        }
+        CHECK_EQ(mismatches, 0);
+        CHECK_GT(exact.getDenominator().bitLength(), 4000);
+        CHECK_LT(x.width(), BigFraction(Fraction(1, 100)));
+
+        FractionInterval straddle(Fraction(-1, 2), Fraction(1, 2));
+        CHECK_THROWS_AS(static_cast<void>(x / straddle), std::runtime_error);
+        FractionInterval large(Fraction(2000000000, 1));
+        CHECK_THROWS_AS(static_cast<void>(large + large), std::overflow_error);
+        x /= FractionInterval(Fraction(1, 2), Fraction(1, 1));
+        CHECK(x.contains(FractionInterval(x.getLower())));
+    }
+}
+
+/**
+ * Upstream memory resource that counts the bytes it hands out and takes back.
+ */
+class CountingResource : public std::pmr::memory_resource {
+
+public:
+
+    size_t allocated = 0;
+    size_t outstanding = 0;
+
+private:
+
+    void *do_allocate(size_t bytes, size_t alignment) override {
+        allocated += bytes;
+        outstanding += bytes;
+        return std::pmr::new_delete_resource()->allocate(bytes, alignment);
+    }
+
+    void do_deallocate(void *pointer, size_t bytes, size_t alignment) override {
+        outstanding -= bytes;
+        std::pmr::new_delete_resource()->deallocate(pointer, bytes, alignment);
+    }
+
+    [[nodiscard]] bool do_is_equal(const std::pmr::memory_resource &other) const noexcept override {
+        return this == &other;
+    }
+};
+
+TEST_SUITE("LimbArena") {
+    TEST_CASE("Scratch comes from the arena inside a scope and is released with it") {
+        CHECK_FALSE(LimbArena::active());
+        CHECK_EQ(LimbArena::current(), nullptr);
+        CHECK_EQ(LimbArena::resource(), std::pmr::get_default_resource());
+
+        CountingResource upstream;
+        BigInt factorial = 1;
+        for (int i = 2; i <= 2000; ++i) factorial *= i;
+        BigInt square;
+        BigInt common;
+        {
+            ArenaScope scope(&upstream, 1024);
+            CHECK(LimbArena::active());
+            {
+                ArenaScope nested;
+                CHECK_NE(LimbArena::resource(), std::pmr::get_default_resource());
+            }
+            CHECK(LimbArena::active());
+            BigInt product = factorial * factorial;
+            square = product;
+            common = BigInt::gcd(product + factorial, factorial * 7);
+            CHECK_GT(upstream.allocated, 0);
+        }
+        CHECK_FALSE(LimbArena::active());
+        CHECK_EQ(upstream.outstanding, 0);
+        CHECK_EQ(square, factorial * factorial);
+        CHECK_EQ(common, factorial);
+        CHECK_EQ(factorial.toString().size(), 5736);
+    }
+
+    TEST_CASE("Values survive the scopes they are moved in") {
+        vector<BigInt> saved;
+        saved.push_back(BigInt(numeric_limits<int64_t>::max()) * BigInt(numeric_limits<int64_t>::max()));
+        BigInt kept;
+        {
+            ArenaScope scope;
+            saved.reserve(64);
+            BigInt local = saved.front() * saved.front();
+            kept = std::move(local);
+            saved.push_back(std::move(kept));
+        }
+        {
+            ArenaScope scope;
+            BigInt noise = 1;
+            for (int i = 2; i <= 500; ++i) noise *= BigInt(numeric_limits<int64_t>::max()) * i;
+            CHECK_EQ(BigInt::gcd(noise, noise + 1), BigInt(1));
+        }
+        CHECK_EQ(saved.front().toString(), "85070591730234615847396907784232501249");
+        CHECK_EQ(saved.back(), saved.front() * saved.front());
+    }
+
+    TEST_CASE("Arena results match heap results") {
+        BigFraction heap;
+        for (int i = 1; i <= 40; ++i) heap += Fraction(1, i);
+        BigFraction arena;
+        {
+            ArenaScope scope;
+            BigFraction sum;
+            for (int i = 1; i <= 40; ++i) sum += Fraction(1, i);
+            arena = sum;
+        }
+        CHECK_EQ(arena, heap);
+    }
+}
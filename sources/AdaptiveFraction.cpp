@@ -0,0 +1,284 @@
+#include "AdaptiveFraction.hpp"
+
+#include <limits>
+#include <numeric>
+#include <stdexcept>
+
+#include "WideArithmetic.hpp"
+
+static const std::int64_t INT_LIMIT = std::numeric_limits<int>::max();
+
+static const std::int64_t INT64_LIMIT = std::numeric_limits<std::int64_t>::max();
+
+/**
+ * @return value as a BigInt, assembled from 32-bit pieces.
+ */
+static BigInt toBigInt(__int128 value) {
+    bool negative = value < 0;
+    auto magnitude = static_cast<unsigned __int128>(value);
+    if (negative) magnitude = -magnitude;
+    BigInt result = 0;
+    for (int shift = 96; shift >= 0; shift -= 32) {
+        result = result * BigInt(std::int64_t{1} << 32) +
+                 BigInt(static_cast<std::int64_t>((magnitude >> static_cast<unsigned>(shift)) & 0xFFFFFFFFU));
+    }
+    return negative ? -result : result;
+}
+
+AdaptiveFraction::AdaptiveFraction() = default;
+
+AdaptiveFraction::AdaptiveFraction(std::int64_t value) : AdaptiveFraction(fromReduced(value, 1)) {}
+
+/**
+ * Constructs a reduced AdaptiveFraction in the narrowest representation that holds it.
+ * @throws std::invalid_argument If the denominator is 0.
+ */
+AdaptiveFraction::AdaptiveFraction(std::int64_t n, std::int64_t d) {
+    if (d == 0) throw invalid_argument("0");
+    *this = fromWide(n, d);
+}
+
+/**
+ * Converts a Fraction exactly, reducing it first: one read with operator>> may not be.
+ */
+AdaptiveFraction::AdaptiveFraction(const Fraction &fraction)
+        : AdaptiveFraction(fromWide(fraction.getNumerator(), fraction.getDenominator())) {}
+
+AdaptiveFraction::AdaptiveFraction(const BigFraction &fraction) : AdaptiveFraction(fromBig(fraction)) {}
+
+AdaptiveFraction::AdaptiveFraction(const AdaptiveFraction &other)
+        : numerator(other.numerator), denominator(other.denominator),
+          big(other.big ? std::make_unique<BigFraction>(*other.big) : nullptr), width(other.width) {}
+
+/**
+ * Takes over other's parts, leaving it as 0.
+ */
+AdaptiveFraction::AdaptiveFraction(AdaptiveFraction &&other) noexcept
+        : numerator(other.numerator), denominator(other.denominator), big(std::move(other.big)), width(other.width) {
+    other.numerator = 0;
+    other.denominator = 1;
+    other.width = Width::Narrow;
+}
+
+AdaptiveFraction &AdaptiveFraction::operator=(const AdaptiveFraction &other) {
+    if (this != &other) *this = AdaptiveFraction(other);
+    return *this;
+}
+
+AdaptiveFraction &AdaptiveFraction::operator=(AdaptiveFraction &&other) noexcept {
+    numerator = other.numerator;
+    denominator = other.denominator;
+    big = std::move(other.big);
+    width = other.width;
+    other.numerator = 0;
+    other.denominator = 1;
+    other.width = Width::Narrow;
+    return *this;
+}
+
+AdaptiveFraction::~AdaptiveFraction() = default;
+
+/**
+ * Stores parts that are already coprime, with a positive denominator, as Narrow if both fit in an int and as Wide
+ * otherwise.
+ */
+AdaptiveFraction AdaptiveFraction::fromReduced(std::int64_t n, std::int64_t d) {
+    AdaptiveFraction result;
+    result.numerator = n;
+    result.denominator = d;
+    if (n < -INT_LIMIT - 1 || n > INT_LIMIT || d > INT_LIMIT) result.width = Width::Wide;
+    return result;
+}
+
+/**
+ * Reduces n/d, computed in 128-bit intermediates, and stores it in the narrowest representation that holds it.
+ * @param d The non-zero denominator.
+ */
+AdaptiveFraction AdaptiveFraction::fromWide(__int128 n, __int128 d) {
+    reduce128(n, d);
+    if (n >= -static_cast<__int128>(INT64_LIMIT) - 1 && n <= INT64_LIMIT && d <= INT64_LIMIT) {
+        return fromReduced(static_cast<std::int64_t>(n), static_cast<std::int64_t>(d));
+    }
+    return fromBig(BigFraction(toBigInt(n), toBigInt(d)));
+}
+
+/**
+ * Stores a BigFraction, demoting it to Wide or Narrow if its parts fit in 64 bits.
+ */
+AdaptiveFraction AdaptiveFraction::fromBig(BigFraction value) {
+    if (value.getNumerator().fitsInt64() && value.getDenominator().fitsInt64()) {
+        return fromReduced(value.getNumerator().toInt64(), value.getDenominator().toInt64());
+    }
+    AdaptiveFraction result;
+    result.big = std::make_unique<BigFraction>(std::move(value));
+    result.width = Width::Big;
+    return result;
+}
+
+AdaptiveFraction::Width AdaptiveFraction::getWidth() const {
+    return width;
+}
+
+/**
+ * @return True if the value is Narrow, so that toFraction succeeds.
+ */
+bool AdaptiveFraction::fitsFraction() const {
+    return width == Width::Narrow;
+}
+
+/**
+ * @throws std::overflow_error If a part does not fit in an int.
+ * @return The same value as a Fraction.
+ */
+Fraction AdaptiveFraction::toFraction() const {
+    if (width != Width::Narrow) throw std::overflow_error("Integer overflow");
+    return Fraction::fromReduced(static_cast<int>(numerator), static_cast<int>(denominator));
+}
+
+BigFraction AdaptiveFraction::toBigFraction() const {
+    if (width == Width::Big) return *big;
+    return {BigInt(numerator), BigInt(denominator)};
+}
+
+/**
+ * @return The fraction as "numerator/denominator", matching the Fraction output format.
+ */
+std::string AdaptiveFraction::toString() const {
+    if (width == Width::Big) return big->toString();
+    return std::to_string(numerator) + "/" + std::to_string(denominator);
+}
+
+std::ostream &operator<<(std::ostream &outstream, const AdaptiveFraction &fraction) {
+    return outstream << fraction.toString();
+}
+
+AdaptiveFraction AdaptiveFraction::operator-() const {
+    if (width == Width::Big || numerator == std::numeric_limits<std::int64_t>::min()) return fromBig(-toBigFraction());
+    return fromReduced(-numerator, denominator);
+}
+
+/**
+ * Adds or subtracts over the product of the denominators in the widest intermediate the operands need: 64 bits for
+ * two Narrow operands, 128 bits when either is Wide, BigFraction when either is Big.
+ */
+AdaptiveFraction AdaptiveFraction::addSigned(const AdaptiveFraction &left, const AdaptiveFraction &right,
+                                             bool negateRight) {
+    if (left.width == Width::Narrow && right.width == Width::Narrow) [[likely]] {
+        std::int64_t cross = right.numerator * left.denominator;
+        std::int64_t n = left.numerator * right.denominator + (negateRight ? -cross : cross);
+        std::int64_t d = left.denominator * right.denominator;
+        std::int64_t gcd = std::gcd(n, d);
+        return fromReduced(n / gcd, d / gcd);
+    }
+    if (left.width != Width::Big && right.width != Width::Big) {
+        __int128 cross = static_cast<__int128>(right.numerator) * left.denominator;
+        return fromWide(static_cast<__int128>(left.numerator) * right.denominator + (negateRight ? -cross : cross),
+                        static_cast<__int128>(left.denominator) * right.denominator);
+    }
+    BigFraction rightBig = right.toBigFraction();
+    return fromBig(negateRight ? left.toBigFraction() - rightBig : left.toBigFraction() + rightBig);
+}
+
+AdaptiveFraction operator+(const AdaptiveFraction &left, const AdaptiveFraction &right) {
+    return AdaptiveFraction::addSigned(left, right, false);
+}
+
+AdaptiveFraction operator-(const AdaptiveFraction &left, const AdaptiveFraction &right) {
+    return AdaptiveFraction::addSigned(left, right, true);
+}
+
+AdaptiveFraction operator*(const AdaptiveFraction &left, const AdaptiveFraction &right) {
+    using Width = AdaptiveFraction::Width;
+    if (left.width == Width::Narrow && right.width == Width::Narrow) [[likely]] {
+        std::int64_t n = left.numerator * right.numerator;
+        std::int64_t d = left.denominator * right.denominator;
+        std::int64_t gcd = std::gcd(n, d);
+        return AdaptiveFraction::fromReduced(n / gcd, d / gcd);
+    }
+    if (left.width != Width::Big && right.width != Width::Big) {
+        return AdaptiveFraction::fromWide(static_cast<__int128>(left.numerator) * right.numerator,
+                                          static_cast<__int128>(left.denominator) * right.denominator);
+    }
+    return AdaptiveFraction::fromBig(left.toBigFraction() * right.toBigFraction());
+}
+
+/**
+ * @throws std::runtime_error If the divisor is 0.
+ */
+AdaptiveFraction operator/(const AdaptiveFraction &left, const AdaptiveFraction &right) {
+    using Width = AdaptiveFraction::Width;
+    if (right.width != Width::Big && right.numerator == 0) throw std::runtime_error("Division by 0 is not defined.");
+    if (left.width == Width::Narrow && right.width == Width::Narrow) [[likely]] {
+        std::int64_t n = left.numerator * right.denominator;
+        std::int64_t d = left.denominator * right.numerator;
+        if (d < 0) {
+            n = -n;
+            d = -d;
+        }
+        std::int64_t gcd = std::gcd(n, d);
+        return AdaptiveFraction::fromReduced(n / gcd, d / gcd);
+    }
+    if (left.width != Width::Big && right.width != Width::Big) {
+        return AdaptiveFraction::fromWide(static_cast<__int128>(left.numerator) * right.denominator,
+                                          static_cast<__int128>(left.denominator) * right.numerator);
+    }
+    return AdaptiveFraction::fromBig(left.toBigFraction() / right.toBigFraction());
+}
+
+AdaptiveFraction &AdaptiveFraction::operator+=(const AdaptiveFraction &other) {
+    return *this = *this + other;
+}
+
+AdaptiveFraction &AdaptiveFraction::operator-=(const AdaptiveFraction &other) {
+    return *this = *this - other;
+}
+
+AdaptiveFraction &AdaptiveFraction::operator*=(const AdaptiveFraction &other) {
+    return *this = *this * other;
+}
+
+AdaptiveFraction &AdaptiveFraction::operator/=(const AdaptiveFraction &other) {
+    return *this = *this / other;
+}
+
+/**
+ * Compares by cross-multiplication in 128 bits, or as BigFractions when either value is Big.
+ * @return A negative number, zero or a positive number as left is below, equal to or above right.
+ */
+int AdaptiveFraction::compare(const AdaptiveFraction &left, const AdaptiveFraction &right) {
+    if (left.width == Width::Big || right.width == Width::Big) {
+        return BigFraction::compare(left.toBigFraction(), right.toBigFraction());
+    }
+    __int128 first = static_cast<__int128>(left.numerator) * right.denominator;
+    __int128 second = static_cast<__int128>(right.numerator) * left.denominator;
+    return first < second ? -1 : (first > second ? 1 : 0);
+}
+
+/**
+ * Values are canonical, so equal values have the same width and the same parts.
+ */
+bool operator==(const AdaptiveFraction &left, const AdaptiveFraction &right) {
+    if (left.width != right.width) return false;
+    if (left.width == AdaptiveFraction::Width::Big) return *left.big == *right.big;
+    return left.numerator == right.numerator && left.denominator == right.denominator;
+}
+
+bool operator!=(const AdaptiveFraction &left, const AdaptiveFraction &right) {
+    return !(left == right);
+}
+
+bool operator<(const AdaptiveFraction &left, const AdaptiveFraction &right) {
+    return AdaptiveFraction::compare(left, right) < 0;
+}
+
+bool operator>(const AdaptiveFraction &left, const AdaptiveFraction &right) {
+    return AdaptiveFraction::compare(left, right) > 0;
+}
+
+bool operator<=(const AdaptiveFraction &left, const AdaptiveFraction &right) {
+    return AdaptiveFraction::compare(left, right) <= 0;
+}
+
+bool operator>=(const AdaptiveFraction &left, const AdaptiveFraction &right) {
+    return AdaptiveFraction::compare(left, right) >= 0;
+}
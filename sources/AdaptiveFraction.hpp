@@ -0,0 +1,113 @@
+#ifndef FRACTION_ADAPTIVE_FRACTION_HPP
+#define FRACTION_ADAPTIVE_FRACTION_HPP
+
+#include <cstdint>
+#include <iostream>
+#include <memory>
+#include <string>
+
+#include "BigFraction.hpp"
+#include "Fraction.hpp"
+
+/**
+ * An exact reduced fraction that widens on overflow instead of throwing.
+ *
+ * The value is stored in the narrowest of three representations that holds it, recorded in a tag:
+ * Narrow parts fit in an int, as in Fraction, and arithmetic on them runs in 64-bit intermediates that cannot overflow;
+ * Wide parts fit in an int64_t, and arithmetic runs in 128-bit intermediates; Big values live on the heap as a
+ * BigFraction. Every result is reduced and then stored in the narrowest representation that holds it, so values that
+ * shrink back after cancellation return to the fast paths.
+ */
+class AdaptiveFraction {
+
+public:
+
+    enum class Width : std::uint8_t {
+        Narrow,
+        Wide,
+        Big
+    };
+
+private:
+
+    std::int64_t numerator = 0;
+    std::int64_t denominator = 1;
+    std::unique_ptr<BigFraction> big;
+    Width width = Width::Narrow;
+
+    static AdaptiveFraction fromReduced(std::int64_t numerator, std::int64_t denominator);
+
+    static AdaptiveFraction fromWide(__int128 numerator, __int128 denominator);
+
+    static AdaptiveFraction fromBig(BigFraction value);
+
+    static AdaptiveFraction addSigned(const AdaptiveFraction &left, const AdaptiveFraction &right, bool negateRight);
+
+public:
+
+    AdaptiveFraction();
+
+    AdaptiveFraction(std::int64_t value);
+
+    AdaptiveFraction(std::int64_t numerator, std::int64_t denominator);
+
+    AdaptiveFraction(const Fraction &fraction);
+
+    AdaptiveFraction(const BigFraction &fraction);
+
+    AdaptiveFraction(const AdaptiveFraction &other);
+
+    AdaptiveFraction(AdaptiveFraction &&other) noexcept;
+
+    AdaptiveFraction &operator=(const AdaptiveFraction &other);
+
+    AdaptiveFraction &operator=(AdaptiveFraction &&other) noexcept;
+
+    ~AdaptiveFraction();
+
+    [[nodiscard]] Width getWidth() const;
+
+    [[nodiscard]] bool fitsFraction() const;
+
+    [[nodiscard]] Fraction toFraction() const;
+
+    [[nodiscard]] BigFraction toBigFraction() const;
+
+    [[nodiscard]] std::string toString() const;
+
+    friend std::ostream &operator<<(std::ostream &outstream, const AdaptiveFraction &fraction);
+
+    AdaptiveFraction operator-() const;
+
+    friend AdaptiveFraction operator+(const AdaptiveFraction &left, const AdaptiveFraction &right);
+
+    friend AdaptiveFraction operator-(const AdaptiveFraction &left, const AdaptiveFraction &right);
+
+    friend AdaptiveFraction operator*(const AdaptiveFraction &left, const AdaptiveFraction &right);
+
+    friend AdaptiveFraction operator/(const AdaptiveFraction &left, const AdaptiveFraction &right);
+
+    AdaptiveFraction &operator+=(const AdaptiveFraction &other);
+
+    AdaptiveFraction &operator-=(const AdaptiveFraction &other);
+
+    AdaptiveFraction &operator*=(const AdaptiveFraction &other);
+
+    AdaptiveFraction &operator/=(const AdaptiveFraction &other);
+
+    friend bool operator==(const AdaptiveFraction &left, const AdaptiveFraction &right);
+
+    friend bool operator!=(const AdaptiveFraction &left, const AdaptiveFraction &right);
+
+    friend bool operator<(const AdaptiveFraction &left, const AdaptiveFraction &right);
+
+    friend bool operator>(const AdaptiveFraction &left, const AdaptiveFraction &right);
+
+    friend bool operator<=(const AdaptiveFraction &left, const AdaptiveFraction &right);
+
+    friend bool operator>=(const AdaptiveFraction &left, const AdaptiveFraction &right);
+
+    static int compare(const AdaptiveFraction &left, const AdaptiveFraction &right);
+};
+
+#endif
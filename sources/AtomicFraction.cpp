@@ -0,0 +1,125 @@
+#include "AtomicFraction.hpp"
+
+#include "FractionHash.hpp"
+
+/**
+ * Packs a Fraction that is already normalised.
+ */
+std::uint64_t AtomicFraction::pack(const Fraction &fraction) {
+    return packFractionKey(fraction.getNumerator(), fraction.getDenominator());
+}
+
+/**
+ * Packs any Fraction after normalising it like Fraction(int, int), so that equal values pack to equal words
+ * (fractions read with operator>> may not be reduced).
+ */
+std::uint64_t AtomicFraction::normalise(const Fraction &fraction) {
+    return pack(Fraction(fraction.getNumerator(), fraction.getDenominator()));
+}
+
+Fraction AtomicFraction::unpack(std::uint64_t word) {
+    return Fraction::fromReduced(static_cast<int>(static_cast<std::uint32_t>(word >> 32U)),
+                                 static_cast<int>(static_cast<std::uint32_t>(word)));
+}
+
+AtomicFraction::AtomicFraction() : bits(pack(Fraction())) {}
+
+AtomicFraction::AtomicFraction(const Fraction &fraction) : bits(normalise(fraction)) {}
+
+/**
+ * @return True if the underlying 64-bit word is lock free on this platform.
+ */
+bool AtomicFraction::is_lock_free() const {
+    return bits.is_lock_free();
+}
+
+Fraction AtomicFraction::load(std::memory_order order) const {
+    return unpack(bits.load(order));
+}
+
+void AtomicFraction::store(const Fraction &fraction, std::memory_order order) {
+    bits.store(normalise(fraction), order);
+}
+
+/**
+ * Replaces the value.
+ * @return The previous value.
+ */
+Fraction AtomicFraction::exchange(const Fraction &fraction, std::memory_order order) {
+    return unpack(bits.exchange(normalise(fraction), order));
+}
+
+/**
+ * Replaces the value with desired if it equals expected; otherwise loads the current value into expected.
+ * May fail spuriously.
+ * @return True if the value was replaced.
+ */
+bool AtomicFraction::compare_exchange_weak(Fraction &expected, const Fraction &desired, std::memory_order order) {
+    std::uint64_t current = normalise(expected);
+    bool exchanged = bits.compare_exchange_weak(current, normalise(desired), order);
+    if (!exchanged) expected = unpack(current);
+    return exchanged;
+}
+
+/**
+ * Replaces the value with desired if it equals expected; otherwise loads the current value into expected.
+ * @return True if the value was replaced.
+ */
+bool AtomicFraction::compare_exchange_strong(Fraction &expected, const Fraction &desired, std::memory_order order) {
+    std::uint64_t current = normalise(expected);
+    bool exchanged = bits.compare_exchange_strong(current, normalise(desired), order);
+    if (!exchanged) expected = unpack(current);
+    return exchanged;
+}
+
+/**
+ * Applies op to the current value in a compare-and-swap loop. The Fraction operators already return normalised
+ * results, so the new value is packed without another gcd.
+ * @return The value before the update.
+ */
+template<class Op>
+Fraction AtomicFraction::update(Op op, std::memory_order order) {
+    std::uint64_t current = bits.load(std::memory_order_relaxed);
+    while (true) {
+        Fraction previous = unpack(current);
+        std::uint64_t next = pack(op(previous));
+        if (bits.compare_exchange_weak(current, next, order, std::memory_order_relaxed)) return previous;
+    }
+}
+
+/**
+ * Atomically adds fraction with Fraction::operator+.
+ * @throws std::overflow_error If the sum overflows; the value is then unchanged.
+ * @return The value before the addition.
+ */
+Fraction AtomicFraction::fetch_add(const Fraction &fraction, std::memory_order order) {
+    return update([&fraction](const Fraction &value) { return value + fraction; }, order);
+}
+
+/**
+ * Atomically subtracts fraction with Fraction::operator-.
+ * @throws std::overflow_error If the difference overflows; the value is then unchanged.
+ * @return The value before the subtraction.
+ */
+Fraction AtomicFraction::fetch_sub(const Fraction &fraction, std::memory_order order) {
+    return update([&fraction](const Fraction &value) { return value - fraction; }, order);
+}
+
+/**
+ * Atomically multiplies by fraction with Fraction::operator*.
+ * @throws std::overflow_error If the product overflows; the value is then unchanged.
+ * @return The value before the multiplication.
+ */
+Fraction AtomicFraction::fetch_mul(const Fraction &fraction, std::memory_order order) {
+    return update([&fraction](const Fraction &value) { return value * fraction; }, order);
+}
+
+/**
+ * Atomically divides by fraction with Fraction::operator/.
+ * @throws std::runtime_error If fraction is 0; the value is then unchanged.
+ * @throws std::overflow_error If the quotient overflows; the value is then unchanged.
+ * @return The value before the division.
+ */
+Fraction AtomicFraction::fetch_div(const Fraction &fraction, std::memory_order order) {
+    return update([&fraction](const Fraction &value) { return value / fraction; }, order);
+}
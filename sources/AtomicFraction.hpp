@@ -0,0 +1,72 @@
+#ifndef ATOMIC_FRACTION_HPP
+#define ATOMIC_FRACTION_HPP
+
+#include <atomic>
+#include <cstdint>
+
+#include "Fraction.hpp"
+
+/**
+ * A Fraction that can be shared between threads without a lock.
+ *
+ * The reduced numerator and denominator are packed into one 64-bit word, so loads and stores are single atomic
+ * operations and read-modify-write operations are compare-and-swap loops around the ordinary Fraction operators.
+ * Values are kept in the normalised form of Fraction(int, int), so equal values always have equal words and
+ * compare_exchange compares values. If an operator throws (overflow, division by 0) the stored value is unchanged.
+ * The member names follow std::atomic.
+ */
+class AtomicFraction {
+
+private:
+
+    std::atomic<std::uint64_t> bits;
+
+    static std::uint64_t pack(const Fraction &fraction);
+
+    static std::uint64_t normalise(const Fraction &fraction);
+
+    static Fraction unpack(std::uint64_t word);
+
+    template<class Op>
+    Fraction update(Op op, std::memory_order order);
+
+public:
+
+    AtomicFraction();
+
+    explicit AtomicFraction(const Fraction &fraction);
+
+    AtomicFraction(const AtomicFraction &) = delete;
+
+    AtomicFraction &operator=(const AtomicFraction &) = delete;
+
+    AtomicFraction(AtomicFraction &&) = delete;
+
+    AtomicFraction &operator=(AtomicFraction &&) = delete;
+
+    ~AtomicFraction() = default;
+
+    [[nodiscard]] bool is_lock_free() const;
+
+    [[nodiscard]] Fraction load(std::memory_order order = std::memory_order_seq_cst) const;
+
+    void store(const Fraction &fraction, std::memory_order order = std::memory_order_seq_cst);
+
+    Fraction exchange(const Fraction &fraction, std::memory_order order = std::memory_order_seq_cst);
+
+    bool compare_exchange_weak(Fraction &expected, const Fraction &desired,
+                               std::memory_order order = std::memory_order_seq_cst);
+
+    bool compare_exchange_strong(Fraction &expected, const Fraction &desired,
+                                 std::memory_order order = std::memory_order_seq_cst);
+
+    Fraction fetch_add(const Fraction &fraction, std::memory_order order = std::memory_order_seq_cst);
+
+    Fraction fetch_sub(const Fraction &fraction, std::memory_order order = std::memory_order_seq_cst);
+
+    Fraction fetch_mul(const Fraction &fraction, std::memory_order order = std::memory_order_seq_cst);
+
+    Fraction fetch_div(const Fraction &fraction, std::memory_order order = std::memory_order_seq_cst);
+};
+
+#endif
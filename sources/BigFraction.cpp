@@ -0,0 +1,183 @@
+#include "BigFraction.hpp"
+
+#include <limits>
+#include <numeric>
+#include <stdexcept>
+
+static const BigInt ONE(1);
+
+BigFraction::BigFraction() : numerator(0), denominator(1) {}
+
+BigFraction::BigFraction(std::int64_t value) : numerator(value), denominator(1) {}
+
+/**
+ * Converts a Fraction exactly. A Fraction read with operator>> may not be reduced, so its parts are reduced by one
+ * machine-word gcd.
+ */
+BigFraction::BigFraction(const Fraction &fraction) {
+    std::int64_t n = fraction.getNumerator();
+    std::int64_t d = fraction.getDenominator();
+    std::int64_t gcd = std::gcd(n, d);
+    numerator = n / gcd;
+    denominator = d / gcd;
+}
+
+/**
+ * Constructs a BigFraction with the given numerator and denominator, reduced and with a positive denominator.
+ * @throws std::invalid_argument If the denominator is 0.
+ */
+BigFraction::BigFraction(const BigInt &n, const BigInt &d) {
+    if (d.isZero()) throw invalid_argument("0");
+    BigInt gcd = BigInt::gcd(n, d);
+    if (d.sign() < 0) gcd = -gcd;
+    numerator = n / gcd;
+    denominator = d / gcd;
+}
+
+/**
+ * Builds a BigFraction from parts that are already coprime, with a positive denominator.
+ */
+BigFraction BigFraction::fromReduced(BigInt n, BigInt d) {
+    BigFraction result;
+    result.numerator = std::move(n);
+    result.denominator = std::move(d);
+    return result;
+}
+
+const BigInt &BigFraction::getNumerator() const {
+    return numerator;
+}
+
+const BigInt &BigFraction::getDenominator() const {
+    return denominator;
+}
+
+/**
+ * @return True if both parts fit in an int, so that toFraction succeeds.
+ */
+bool BigFraction::fitsFraction() const {
+    if (!numerator.fitsInt64() || !denominator.fitsInt64()) return false;
+    std::int64_t n = numerator.toInt64();
+    std::int64_t d = denominator.toInt64();
+    return n >= std::numeric_limits<int>::min() && n <= std::numeric_limits<int>::max() &&
+           d <= std::numeric_limits<int>::max();
+}
+
+/**
+ * @throws std::overflow_error If a part does not fit in an int.
+ * @return The same value as a Fraction.
+ */
+Fraction BigFraction::toFraction() const {
+    if (!fitsFraction()) throw std::overflow_error("Integer overflow");
+    return Fraction::fromReduced(static_cast<int>(numerator.toInt64()), static_cast<int>(denominator.toInt64()));
+}
+
+/**
+ * @return The fraction as "numerator/denominator", matching the Fraction output format.
+ */
+std::string BigFraction::toString() const {
+    return numerator.toString() + "/" + denominator.toString();
+}
+
+std::ostream &operator<<(std::ostream &outstream, const BigFraction &fraction) {
+    return outstream << fraction.toString();
+}
+
+BigFraction BigFraction::operator-() const {
+    return fromReduced(-numerator, denominator);
+}
+
+/**
+ * Adds over the least common denominator (Henrici's method): with g = gcd(b, d), a/b + c/d has the numerator
+ * t = a(d/g) + c(b/g), and only gcd(t, g) can still divide it, so the operands never grow beyond the result.
+ */
+BigFraction operator+(const BigFraction &left, const BigFraction &right) {
+    const BigInt &b = left.denominator;
+    const BigInt &d = right.denominator;
+    if (b == ONE && d == ONE) return BigFraction::fromReduced(left.numerator + right.numerator, ONE);
+    BigInt g = BigInt::gcd(b, d);
+    if (g == ONE) return BigFraction::fromReduced(left.numerator * d + right.numerator * b, b * d);
+    BigInt t = left.numerator * (d / g) + right.numerator * (b / g);
+    BigInt g2 = BigInt::gcd(t, g);
+    if (g2 == ONE) return BigFraction::fromReduced(std::move(t), b / g * d);
+    return BigFraction::fromReduced(t / g2, b / g * (d / g2));
+}
+
+BigFraction operator-(const BigFraction &left, const BigFraction &right) {
+    return left + -right;
+}
+
+/**
+ * Multiplies after cancelling across: (a/b)(c/d) = (a/g1)(c/g2) / ((b/g2)(d/g1)) with g1 = gcd(a, d) and
+ * g2 = gcd(c, b), which is already reduced.
+ */
+BigFraction operator*(const BigFraction &left, const BigFraction &right) {
+    if (left.numerator.isZero() || right.numerator.isZero()) return {};
+    BigInt g1 = BigInt::gcd(left.numerator, right.denominator);
+    BigInt g2 = BigInt::gcd(right.numerator, left.denominator);
+    return BigFraction::fromReduced((left.numerator / g1) * (right.numerator / g2),
+                                    (left.denominator / g2) * (right.denominator / g1));
+}
+
+/**
+ * @throws std::runtime_error If the divisor is 0.
+ */
+BigFraction operator/(const BigFraction &left, const BigFraction &right) {
+    if (right.numerator.isZero()) throw std::runtime_error("Division by 0 is not defined.");
+    BigFraction reciprocal = right.numerator.sign() < 0
+                             ? BigFraction::fromReduced(-right.denominator, -right.numerator)
+                             : BigFraction::fromReduced(right.denominator, right.numerator);
+    return left * reciprocal;
+}
+
+BigFraction &BigFraction::operator+=(const BigFraction &other) {
+    return *this = *this + other;
+}
+
+BigFraction &BigFraction::operator-=(const BigFraction &other) {
+    return *this = *this - other;
+}
+
+BigFraction &BigFraction::operator*=(const BigFraction &other) {
+    return *this = *this * other;
+}
+
+BigFraction &BigFraction::operator/=(const BigFraction &other) {
+    return *this = *this / other;
+}
+
+/**
+ * Compares by cross-multiplication, after a sign check that settles most comparisons without multiplying.
+ * @return A negative number, zero or a positive number as left is below, equal to or above right.
+ */
+int BigFraction::compare(const BigFraction &left, const BigFraction &right) {
+    int leftSign = left.numerator.sign();
+    int rightSign = right.numerator.sign();
+    if (leftSign != rightSign) return leftSign < rightSign ? -1 : 1;
+    if (left.denominator == right.denominator) return BigInt::compare(left.numerator, right.numerator);
+    return BigInt::compare(left.numerator * right.denominator, right.numerator * left.denominator);
+}
+
+bool operator==(const BigFraction &left, const BigFraction &right) {
+    return left.numerator == right.numerator && left.denominator == right.denominator;
+}
+
+bool operator!=(const BigFraction &left, const BigFraction &right) {
+    return !(left == right);
+}
+
+bool operator<(const BigFraction &left, const BigFraction &right) {
+    return BigFraction::compare(left, right) < 0;
+}
+
+bool operator>(const BigFraction &left, const BigFraction &right) {
+    return BigFraction::compare(left, right) > 0;
+}
+
+bool operator<=(const BigFraction &left, const BigFraction &right) {
+    return BigFraction::compare(left, right) <= 0;
+}
+
+bool operator>=(const BigFraction &left, const BigFraction &right) {
+    return BigFraction::compare(left, right) >= 0;
+}
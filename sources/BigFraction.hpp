@@ -0,0 +1,82 @@
+#ifndef FRACTION_BIG_FRACTION_HPP
+#define FRACTION_BIG_FRACTION_HPP
+
+#include <cstdint>
+#include <iostream>
+#include <string>
+
+#include "BigInt.hpp"
+#include "Fraction.hpp"
+
+/**
+ * An exact reduced fraction with arbitrary-precision parts, for computations whose results outgrow Fraction.
+ *
+ * The parts are BigInts, so while they fit in 64 bits no memory is allocated and arithmetic runs on machine words.
+ * Operations never overflow; converting back with toFraction throws if the result does not fit in a Fraction.
+ * Fractions convert implicitly, so mixed expressions such as fraction + bigFraction are evaluated exactly.
+ */
+class BigFraction {
+
+private:
+
+    BigInt numerator;
+    BigInt denominator;
+
+    static BigFraction fromReduced(BigInt numerator, BigInt denominator);
+
+public:
+
+    BigFraction();
+
+    BigFraction(std::int64_t value);
+
+    BigFraction(const Fraction &fraction);
+
+    BigFraction(const BigInt &numerator, const BigInt &denominator);
+
+    [[nodiscard]] const BigInt &getNumerator() const;
+
+    [[nodiscard]] const BigInt &getDenominator() const;
+
+    [[nodiscard]] bool fitsFraction() const;
+
+    [[nodiscard]] Fraction toFraction() const;
+
+    [[nodiscard]] std::string toString() const;
+
+    friend std::ostream &operator<<(std::ostream &outstream, const BigFraction &fraction);
+
+    BigFraction operator-() const;
+
+    friend BigFraction operator+(const BigFraction &left, const BigFraction &right);
+
+    friend BigFraction operator-(const BigFraction &left, const BigFraction &right);
+
+    friend BigFraction operator*(const BigFraction &left, const BigFraction &right);
+
+    friend BigFraction operator/(const BigFraction &left, const BigFraction &right);
+
+    BigFraction &operator+=(const BigFraction &other);
+
+    BigFraction &operator-=(const BigFraction &other);
+
+    BigFraction &operator*=(const BigFraction &other);
+
+    BigFraction &operator/=(const BigFraction &other);
+
+    friend bool operator==(const BigFraction &left, const BigFraction &right);
+
+    friend bool operator!=(const BigFraction &left, const BigFraction &right);
+
+    friend bool operator<(const BigFraction &left, const BigFraction &right);
+
+    friend bool operator>(const BigFraction &left, const BigFraction &right);
+
+    friend bool operator<=(const BigFraction &left, const BigFraction &right);
+
+    friend bool operator>=(const BigFraction &left, const BigFraction &right);
+
+    static int compare(const BigFraction &left, const BigFraction &right);
+};
+
+#endif
@@ -0,0 +1,937 @@
+#include "BigInt.hpp"
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <limits>
+#include <numeric>
+#include <stdexcept>
+
+using Limbs = BigInt::Limbs;
+
+/**
+ * @return An allocator for limbs that do not outlive the current operation.
+ */
+static Limbs::allocator_type scratch() {
+    return Limbs::allocator_type::scratch();
+}
+
+static const std::uint64_t LIMB_BASE = std::uint64_t{1} << 32U;
+
+static void trim(Limbs &limbs) {
+    while (!limbs.empty() && limbs.back() == 0) limbs.pop_back();
+}
+
+/**
+ * @return The magnitude of value, correct for INT64_MIN as well.
+ */
+static std::uint64_t magnitude64(std::int64_t value) {
+    return value < 0 ? std::uint64_t{0} - static_cast<std::uint64_t>(value) : static_cast<std::uint64_t>(value);
+}
+
+/**
+ * @return A negative number, zero or a positive number as the magnitude a is below, equal to or above b.
+ */
+static int compareMagnitudes(const Limbs &a, const Limbs &b) {
+    if (a.size() != b.size()) return a.size() < b.size() ? -1 : 1;
+    for (std::size_t i = a.size(); i-- > 0;) {
+        if (a[i] != b[i]) return a[i] < b[i] ? -1 : 1;
+    }
+    return 0;
+}
+
+static Limbs addMagnitudes(const Limbs &a, const Limbs &b) {
+    const Limbs &longer = a.size() >= b.size() ? a : b;
+    const Limbs &shorter = a.size() >= b.size() ? b : a;
+    Limbs sum(longer.size() + 1, a.get_allocator());
+    std::uint64_t carry = 0;
+    for (std::size_t i = 0; i < longer.size(); ++i) {
+        carry += longer[i];
+        if (i < shorter.size()) carry += shorter[i];
+        sum[i] = static_cast<std::uint32_t>(carry);
+        carry >>= 32U;
+    }
+    sum[longer.size()] = static_cast<std::uint32_t>(carry);
+    trim(sum);
+    return sum;
+}
+
+/**
+ * @return The magnitude a - b, where a is at least b.
+ */
+static Limbs subtractMagnitudes(const Limbs &a, const Limbs &b) {
+    Limbs difference(a.size(), a.get_allocator());
+    std::uint64_t borrow = 0;
+    for (std::size_t i = 0; i < a.size(); ++i) {
+        std::uint64_t subtrahend = borrow + (i < b.size() ? b[i] : 0U);
+        std::uint64_t minuend = a[i];
+        borrow = minuend < subtrahend ? 1 : 0;
+        difference[i] = static_cast<std::uint32_t>(minuend + (borrow << 32U) - subtrahend);
+    }
+    trim(difference);
+    return difference;
+}
+
+/**
+ * Schoolbook multiplication of two magnitudes.
+ */
+static Limbs multiplySchoolbook(const Limbs &a, const Limbs &b) {
+    if (a.empty() || b.empty()) return {};
+    Limbs product(a.size() + b.size(), a.get_allocator());
+    for (std::size_t i = 0; i < a.size(); ++i) {
+        std::uint64_t carry = 0;
+        std::uint64_t digit = a[i];
+        for (std::size_t j = 0; j < b.size(); ++j) {
+            carry += digit * b[j] + product[i + j];
+            product[i + j] = static_cast<std::uint32_t>(carry);
+            carry >>= 32U;
+        }
+        product[i + b.size()] = static_cast<std::uint32_t>(carry);
+    }
+    trim(product);
+    return product;
+}
+
+/**
+ * @return The magnitude formed by up to count limbs of a starting at from, as scratch.
+ */
+static Limbs slice(const Limbs &a, std::size_t from, std::size_t count) {
+    if (from >= a.size()) return {};
+    Limbs part(a.begin() + static_cast<std::ptrdiff_t>(from),
+               a.begin() + static_cast<std::ptrdiff_t>(std::min(a.size(), from + count)), scratch());
+    trim(part);
+    return part;
+}
+
+/**
+ * Adds value, shifted up by offset limbs, into target, growing target if the sum needs more limbs.
+ */
+static void addShifted(Limbs &target, const Limbs &value, std::size_t offset) {
+    if (target.size() < offset + value.size() + 1) target.resize(offset + value.size() + 1);
+    std::uint64_t carry = 0;
+    std::size_t i = 0;
+    for (; i < value.size(); ++i) {
+        carry += static_cast<std::uint64_t>(target[offset + i]) + value[i];
+        target[offset + i] = static_cast<std::uint32_t>(carry);
+        carry >>= 32U;
+    }
+    for (std::size_t j = offset + i; carry != 0; ++j) {
+        if (j == target.size()) target.push_back(0);
+        carry += target[j];
+        target[j] = static_cast<std::uint32_t>(carry);
+        carry >>= 32U;
+    }
+}
+
+static std::atomic<std::size_t> karatsubaLimbs{BigInt::DEFAULT_KARATSUBA_THRESHOLD};
+
+static std::atomic<std::size_t> toom3Limbs{BigInt::DEFAULT_TOOM3_THRESHOLD};
+
+/**
+ * Multiplies two magnitudes, choosing the algorithm by the length of the shorter one: schoolbook below the Karatsuba
+ * threshold, Karatsuba below the Toom-3 threshold and Toom-3 above it. An operand at least twice as long as the other
+ * is cut into pieces the length of the shorter one, so that each piece is a balanced product.
+ */
+BigInt::Limbs BigInt::multiplyMagnitudes(const Limbs &a, const Limbs &b) {
+    const Limbs &longer = a.size() >= b.size() ? a : b;
+    const Limbs &shorter = a.size() >= b.size() ? b : a;
+    if (shorter.size() < karatsubaLimbs.load(std::memory_order_relaxed)) return multiplySchoolbook(longer, shorter);
+    if (2 * shorter.size() <= longer.size()) {
+        Limbs product(longer.size() + shorter.size(), longer.get_allocator());
+        for (std::size_t from = 0; from < longer.size(); from += shorter.size()) {
+            addShifted(product, multiplyMagnitudes(slice(longer, from, shorter.size()), shorter), from);
+        }
+        trim(product);
+        return product;
+    }
+    if (shorter.size() >= toom3Limbs.load(std::memory_order_relaxed)) return multiplyToom3(longer, shorter);
+    return multiplyKaratsuba(longer, shorter);
+}
+
+/**
+ * Karatsuba multiplication: with a = a1 x + a0 and b = b1 x + b0 for x = 2^(32h),
+ * ab = a1 b1 x^2 + ((a0 + a1)(b0 + b1) - a0 b0 - a1 b1) x + a0 b0, three half-size products instead of four.
+ * @param a The longer magnitude.
+ * @param b The shorter magnitude, more than half as long as a.
+ */
+BigInt::Limbs BigInt::multiplyKaratsuba(const Limbs &a, const Limbs &b) {
+    std::size_t half = (a.size() + 1) / 2;
+    Limbs a0 = slice(a, 0, half);
+    Limbs a1 = slice(a, half, a.size());
+    Limbs b0 = slice(b, 0, half);
+    Limbs b1 = slice(b, half, b.size());
+
+    Limbs low = multiplyMagnitudes(a0, b0);
+    Limbs high = multiplyMagnitudes(a1, b1);
+    Limbs middle = multiplyMagnitudes(addMagnitudes(a0, a1), addMagnitudes(b0, b1));
+    middle = subtractMagnitudes(subtractMagnitudes(middle, low), high);
+
+    Limbs product(a.size() + b.size(), a.get_allocator());
+    addShifted(product, low, 0);
+    addShifted(product, middle, half);
+    addShifted(product, high, 2 * half);
+    trim(product);
+    return product;
+}
+
+/**
+ * Toom-Cook 3-way multiplication. Both operands are split into three pieces of k limbs, read as quadratics in
+ * x = 2^(32k), and evaluated at 0, 1, -1, -2 and infinity; the five pointwise products are recursive multiplications
+ * of a third of the size, and Bodrato's interpolation sequence, which divides only by 2 and 3, recovers the five
+ * coefficients of the product.
+ * @param a The longer magnitude.
+ * @param b The shorter magnitude, more than half as long as a.
+ */
+BigInt::Limbs BigInt::multiplyToom3(const Limbs &a, const Limbs &b) {
+    std::size_t k = (a.size() + 2) / 3;
+    BigInt a0 = fromMagnitude(slice(a, 0, k), false);
+    BigInt a1 = fromMagnitude(slice(a, k, k), false);
+    BigInt a2 = fromMagnitude(slice(a, 2 * k, k), false);
+    BigInt b0 = fromMagnitude(slice(b, 0, k), false);
+    BigInt b1 = fromMagnitude(slice(b, k, k), false);
+    BigInt b2 = fromMagnitude(slice(b, 2 * k, k), false);
+
+    BigInt evenA = a0 + a2;
+    BigInt aAtOne = evenA + a1;
+    BigInt aAtMinusOne = evenA - a1;
+    BigInt aAtMinusTwo = (aAtMinusOne + a2) * 2 - a0;
+    BigInt evenB = b0 + b2;
+    BigInt bAtOne = evenB + b1;
+    BigInt bAtMinusOne = evenB - b1;
+    BigInt bAtMinusTwo = (bAtMinusOne + b2) * 2 - b0;
+
+    BigInt r0 = a0 * b0;
+    BigInt r1 = aAtOne * bAtOne;
+    BigInt rMinusOne = aAtMinusOne * bAtMinusOne;
+    BigInt rMinusTwo = aAtMinusTwo * bAtMinusTwo;
+    BigInt r4 = a2 * b2;
+
+    BigInt r3 = (rMinusTwo - r1) / 3;
+    r1 = (r1 - rMinusOne) / 2;
+    BigInt r2 = rMinusOne - r0;
+    r3 = (r2 - r3) / 2 + r4 * 2;
+    r2 = r2 + r1 - r4;
+    r1 = r1 - r3;
+
+    Limbs product(a.size() + b.size(), a.get_allocator());
+    addShifted(product, r0.magnitude(), 0);
+    addShifted(product, r1.magnitude(), k);
+    addShifted(product, r2.magnitude(), 2 * k);
+    addShifted(product, r3.magnitude(), 3 * k);
+    addShifted(product, r4.magnitude(), 4 * k);
+    trim(product);
+    return product;
+}
+
+/**
+ * Sets the operand lengths, in 32-bit limbs, at which multiplication switches from schoolbook to Karatsuba and from
+ * Karatsuba to Toom-3. The values are clamped to the smallest lengths at which each method still shrinks its
+ * subproblems. Intended for tuning; the defaults come from the big_mul benchmarks.
+ */
+void BigInt::setMultiplyThresholds(std::size_t karatsuba, std::size_t toom3) {
+    karatsubaLimbs.store(std::max<std::size_t>(karatsuba, 4), std::memory_order_relaxed);
+    toom3Limbs.store(std::max<std::size_t>(toom3, 9), std::memory_order_relaxed);
+}
+
+std::size_t BigInt::karatsubaThreshold() {
+    return karatsubaLimbs.load(std::memory_order_relaxed);
+}
+
+std::size_t BigInt::toom3Threshold() {
+    return toom3Limbs.load(std::memory_order_relaxed);
+}
+
+/**
+ * Divides the magnitude u by a single limb in place.
+ * @return The remainder.
+ */
+static std::uint32_t divideBySmall(Limbs &u, std::uint32_t divisor) {
+    std::uint64_t remainder = 0;
+    for (std::size_t i = u.size(); i-- > 0;) {
+        std::uint64_t current = (remainder << 32U) | u[i];
+        u[i] = static_cast<std::uint32_t>(current / divisor);
+        remainder = current % divisor;
+    }
+    trim(u);
+    return static_cast<std::uint32_t>(remainder);
+}
+
+/**
+ * Long division of magnitudes (Knuth, TAOCP vol. 2, algorithm 4.3.1 D).
+ * The divisor is normalised so that its top limb has its high bit set, which keeps every estimated quotient limb at
+ * most 2 above the true one.
+ */
+static void divModMagnitudes(const Limbs &u, const Limbs &v, Limbs &quotient, Limbs &remainder) {
+    if (compareMagnitudes(u, v) < 0) {
+        quotient.clear();
+        remainder = u;
+        return;
+    }
+    if (v.size() == 1) {
+        quotient = u;
+        std::uint32_t rest = divideBySmall(quotient, v[0]);
+        remainder.clear();
+        if (rest != 0) remainder.push_back(rest);
+        return;
+    }
+
+    std::size_t n = v.size();
+    std::size_t m = u.size() - n;
+    auto shift = static_cast<unsigned>(__builtin_clz(v.back()));
+    Limbs vn(n, scratch());
+    Limbs un(u.size() + 1, scratch());
+    for (std::size_t i = n; i-- > 0;) {
+        std::uint64_t wide = (static_cast<std::uint64_t>(v[i]) << 32U) | (i > 0 ? v[i - 1] : 0U);
+        vn[i] = static_cast<std::uint32_t>((wide << shift) >> 32U);
+    }
+    for (std::size_t i = u.size() + 1; i-- > 0;) {
+        std::uint64_t high = i < u.size() ? u[i] : 0U;
+        std::uint64_t wide = (high << 32U) | (i > 0 ? u[i - 1] : 0U);
+        un[i] = static_cast<std::uint32_t>((wide << shift) >> 32U);
+    }
+
+    quotient.assign(m + 1, 0);
+    for (std::size_t j = m + 1; j-- > 0;) {
+        std::uint64_t top = (static_cast<std::uint64_t>(un[j + n]) << 32U) | un[j + n - 1];
+        std::uint64_t qhat = top / vn[n - 1];
+        std::uint64_t rhat = top % vn[n - 1];
+        while (qhat >= LIMB_BASE || qhat * vn[n - 2] > ((rhat << 32U) | un[j + n - 2])) {
+            --qhat;
+            rhat += vn[n - 1];
+            if (rhat >= LIMB_BASE) break;
+        }
+
+        std::int64_t borrow = 0;
+        for (std::size_t i = 0; i < n; ++i) {
+            std::uint64_t product = qhat * vn[i];
+            std::int64_t difference = static_cast<std::int64_t>(un[i + j]) - borrow -
+                                      static_cast<std::int64_t>(product & 0xFFFFFFFFU);
+            un[i + j] = static_cast<std::uint32_t>(difference);
+            borrow = static_cast<std::int64_t>(product >> 32U) - (difference >> 32);
+        }
+        std::int64_t difference = static_cast<std::int64_t>(un[j + n]) - borrow;
+        un[j + n] = static_cast<std::uint32_t>(difference);
+
+        if (difference < 0) {
+            // qhat was one too large: add the divisor back.
+            --qhat;
+            std::uint64_t carry = 0;
+            for (std::size_t i = 0; i < n; ++i) {
+                carry += static_cast<std::uint64_t>(un[i + j]) + vn[i];
+                un[i + j] = static_cast<std::uint32_t>(carry);
+                carry >>= 32U;
+            }
+            un[j + n] = static_cast<std::uint32_t>(un[j + n] + carry);
+        }
+        quotient[j] = static_cast<std::uint32_t>(qhat);
+    }
+    trim(quotient);
+
+    remainder.assign(n, 0);
+    for (std::size_t i = 0; i < n; ++i) {
+        std::uint64_t wide = (static_cast<std::uint64_t>(un[i + 1]) << 32U) | un[i];
+        remainder[i] = static_cast<std::uint32_t>(wide >> shift);
+    }
+    trim(remainder);
+}
+
+/**
+ * @return The number of bits in the magnitude a, 0 for zero.
+ */
+static std::size_t magnitudeBits(const Limbs &a) {
+    if (a.empty()) return 0;
+    return a.size() * 32 - static_cast<std::size_t>(__builtin_clz(a.back()));
+}
+
+/**
+ * @return The magnitude a shifted right by the given number of bits.
+ */
+static Limbs shiftRightMagnitude(const Limbs &a, std::size_t bits) {
+    std::size_t skip = bits / 32;
+    auto shift = static_cast<unsigned>(bits % 32);
+    if (skip >= a.size()) return {};
+    Limbs result(a.size() - skip, a.get_allocator());
+    for (std::size_t i = 0; i < result.size(); ++i) {
+        std::uint64_t wide = a[i + skip];
+        if (i + skip + 1 < a.size()) wide |= static_cast<std::uint64_t>(a[i + skip + 1]) << 32U;
+        result[i] = static_cast<std::uint32_t>(wide >> shift);
+    }
+    trim(result);
+    return result;
+}
+
+/**
+ * @return The magnitude a shifted left by the given number of bits.
+ */
+static Limbs shiftLeftMagnitude(const Limbs &a, std::size_t bits) {
+    if (a.empty()) return {};
+    std::size_t skip = bits / 32;
+    auto shift = static_cast<unsigned>(bits % 32);
+    Limbs result(a.size() + skip + 1, a.get_allocator());
+    for (std::size_t i = 0; i < a.size(); ++i) {
+        std::uint64_t wide = static_cast<std::uint64_t>(a[i]) << shift;
+        result[i + skip] |= static_cast<std::uint32_t>(wide);
+        result[i + skip + 1] = static_cast<std::uint32_t>(wide >> 32U);
+    }
+    trim(result);
+    return result;
+}
+
+/**
+ * @return The lowest bits bits of the magnitude a.
+ */
+static Limbs lowBits(const Limbs &a, std::size_t bits) {
+    Limbs result = slice(a, 0, (bits + 31) / 32);
+    if (bits % 32 != 0 && result.size() == (bits + 31) / 32) result.back() &= (std::uint32_t{1} << (bits % 32)) - 1;
+    trim(result);
+    return result;
+}
+
+/**
+ * @return Bits shift to shift + 63 of the magnitude a.
+ */
+static std::uint64_t bitsAt(const Limbs &a, std::size_t shift) {
+    std::size_t limb = shift / 32;
+    unsigned __int128 window = 0;
+    for (std::size_t i = 0; i < 3 && limb + i < a.size(); ++i) {
+        window |= static_cast<unsigned __int128>(a[limb + i]) << (32U * i);
+    }
+    return static_cast<std::uint64_t>(window >> (shift % 32));
+}
+
+/**
+ * Lehmer's inner loop (Knuth, TAOCP vol. 2, algorithm 4.5.2 L) on the leading 63 bits of a >= b: runs Euclid on the
+ * leading bits for as long as they determine the quotients exactly, and collects the steps taken in cofactors with
+ * a' = x0 a + x1 b and b' = x2 a + x3 b, the remainders the same steps produce on the full values. All cofactor
+ * arithmetic is modulo 2^64, which is exact because every true value, and every sum compared, lies within range.
+ * @return False if the leading bits do not determine even the first quotient, and a full division step is needed.
+ */
+static bool lehmerCofactors(const Limbs &a, const Limbs &b, std::array<std::int64_t, 4> &cofactors) {
+    std::size_t bits = magnitudeBits(a);
+    if (bits <= 63) return false;
+    std::uint64_t u = bitsAt(a, bits - 63);
+    std::uint64_t v = bitsAt(b, bits - 63);
+    std::uint64_t x0 = 1;
+    std::uint64_t x1 = 0;
+    std::uint64_t x2 = 0;
+    std::uint64_t x3 = 1;
+    while (v + x2 != 0 && v + x3 != 0) {
+        std::uint64_t q = (u + x0) / (v + x2);
+        if (q != (u + x1) / (v + x3)) break;
+        std::uint64_t t = x0 - q * x2;
+        x0 = x2;
+        x2 = t;
+        t = x1 - q * x3;
+        x1 = x3;
+        x3 = t;
+        t = u - q * v;
+        u = v;
+        v = t;
+    }
+    if (x1 == 0) return false;
+    cofactors = {static_cast<std::int64_t>(x0), static_cast<std::int64_t>(x1), static_cast<std::int64_t>(x2),
+                 static_cast<std::int64_t>(x3)};
+    return true;
+}
+
+/**
+ * @return x a + y b, for cofactors known to make it non-negative: those from lehmerCofactors, and the entries of the
+ * matrices that record Euclid steps.
+ */
+static Limbs combineMagnitudes(const Limbs &a, const Limbs &b, std::int64_t x, std::int64_t y) {
+    std::size_t size = std::max(a.size(), b.size());
+    Limbs result(size + 2, a.get_allocator());
+    __int128 carry = 0;
+    for (std::size_t i = 0; i < size; ++i) {
+        if (i < a.size()) carry += static_cast<__int128>(x) * a[i];
+        if (i < b.size()) carry += static_cast<__int128>(y) * b[i];
+        result[i] = static_cast<std::uint32_t>(carry);
+        carry >>= 32U;
+    }
+    result[size] = static_cast<std::uint32_t>(carry);
+    result[size + 1] = static_cast<std::uint32_t>(carry >> 32U);
+    trim(result);
+    return result;
+}
+
+/**
+ * Length in limbs below which halfGcd finds its quotients with Lehmer steps instead of recursing.
+ */
+static const std::size_t HALF_GCD_BASE_LIMBS = 32;
+
+static std::atomic<std::size_t> halfGcdLimbs{BigInt::DEFAULT_HALF_GCD_THRESHOLD};
+
+BigInt::BigInt() = default;
+
+BigInt::BigInt(std::int64_t value) : small(value) {}
+
+BigInt::BigInt(const BigInt &other) = default;
+
+BigInt::BigInt(BigInt &&other) = default;
+
+BigInt &BigInt::operator=(const BigInt &other) = default;
+
+BigInt &BigInt::operator=(BigInt &&other) = default;
+
+/**
+ * Builds a BigInt from a sign and magnitude, storing it inline when it fits in an int64_t.
+ */
+BigInt BigInt::fromMagnitude(Limbs magnitude, bool negative) {
+    trim(magnitude);
+    BigInt result;
+    if (magnitude.size() <= 2) {
+        std::uint64_t value = magnitude.empty() ? 0 : magnitude[0];
+        if (magnitude.size() == 2) value |= static_cast<std::uint64_t>(magnitude[1]) << 32U;
+        auto limit = static_cast<std::uint64_t>(std::numeric_limits<std::int64_t>::max());
+        if (!negative && value <= limit) {
+            result.small = static_cast<std::int64_t>(value);
+            return result;
+        }
+        if (negative && value <= limit + 1) {
+            result.small = static_cast<std::int64_t>(std::uint64_t{0} - value);
+            return result;
+        }
+    }
+    result.negative = negative;
+    result.limbs = std::move(magnitude);
+    return result;
+}
+
+BigInt BigInt::fromUnsigned(std::uint64_t value) {
+    if (value <= static_cast<std::uint64_t>(std::numeric_limits<std::int64_t>::max())) return {static_cast<std::int64_t>(value)};
+    return fromMagnitude(Limbs{static_cast<std::uint32_t>(value), static_cast<std::uint32_t>(value >> 32U)}, false);
+}
+
+/**
+ * @return The limbs of the absolute value, for inline values as well, allocated with allocator.
+ */
+BigInt::Limbs BigInt::magnitude(const Limbs::allocator_type &allocator) const {
+    if (!limbs.empty()) return {limbs, allocator};
+    std::uint64_t value = magnitude64(small);
+    Limbs result(allocator);
+    if (value != 0) result.push_back(static_cast<std::uint32_t>(value));
+    if ((value >> 32U) != 0) result.push_back(static_cast<std::uint32_t>(value >> 32U));
+    return result;
+}
+
+bool BigInt::isSmall() const {
+    return limbs.empty();
+}
+
+bool BigInt::isZero() const {
+    return limbs.empty() && small == 0;
+}
+
+int BigInt::sign() const {
+    if (!limbs.empty()) return negative ? -1 : 1;
+    return small < 0 ? -1 : (small > 0 ? 1 : 0);
+}
+
+bool BigInt::fitsInt64() const {
+    return limbs.empty();
+}
+
+/**
+ * @throws std::overflow_error If the value does not fit in an int64_t.
+ * @return The value as an int64_t.
+ */
+std::int64_t BigInt::toInt64() const {
+    if (!limbs.empty()) throw std::overflow_error("Integer overflow");
+    return small;
+}
+
+/**
+ * @return The number of bits in the absolute value, 0 for zero.
+ */
+std::size_t BigInt::bitLength() const {
+    if (limbs.empty()) {
+        std::uint64_t value = magnitude64(small);
+        return value == 0 ? 0 : static_cast<std::size_t>(64 - __builtin_clzll(value));
+    }
+    return limbs.size() * 32 - static_cast<std::size_t>(__builtin_clz(limbs.back()));
+}
+
+/**
+ * @return The number of 32-bit limbs the absolute value occupies.
+ */
+std::size_t BigInt::limbCount() const {
+    return (bitLength() + 31) / 32;
+}
+
+BigInt BigInt::abs() const {
+    return sign() < 0 ? -*this : *this;
+}
+
+/**
+ * @return The value in decimal, with a leading '-' for negative values.
+ */
+std::string BigInt::toString() const {
+    if (limbs.empty()) return std::to_string(small);
+    Limbs rest(limbs, scratch());
+    std::string digits;
+    while (!rest.empty()) {
+        std::uint32_t chunk = divideBySmall(rest, 1000000000U);
+        for (int i = 0; i < 9 && (!rest.empty() || chunk != 0); ++i) {
+            digits.push_back(static_cast<char>('0' + chunk % 10));
+            chunk /= 10;
+        }
+    }
+    if (negative) digits.push_back('-');
+    std::reverse(digits.begin(), digits.end());
+    return digits;
+}
+
+std::ostream &operator<<(std::ostream &outstream, const BigInt &value) {
+    return outstream << value.toString();
+}
+
+BigInt BigInt::operator-() const {
+    if (limbs.empty()) {
+        if (small != std::numeric_limits<std::int64_t>::min()) return {-small};
+        return fromMagnitude(magnitude(), false);
+    }
+    return fromMagnitude(limbs, !negative);
+}
+
+/**
+ * Adds right, or its negation, to left: the shared body of addition and subtraction.
+ */
+BigInt BigInt::addSigned(const BigInt &left, const BigInt &right, bool negateRight) {
+    if (left.limbs.empty() && right.limbs.empty()) {
+        std::int64_t result = 0;
+        bool overflow = negateRight ? __builtin_sub_overflow(left.small, right.small, &result)
+                                    : __builtin_add_overflow(left.small, right.small, &result);
+        if (!overflow) return {result};
+    }
+    bool leftNegative = left.sign() < 0;
+    bool rightNegative = (right.sign() < 0) != negateRight;
+    Limbs a = left.magnitude();
+    Limbs b = right.magnitude();
+    if (leftNegative == rightNegative) return fromMagnitude(addMagnitudes(a, b), leftNegative);
+    if (compareMagnitudes(a, b) >= 0) return fromMagnitude(subtractMagnitudes(a, b), leftNegative);
+    return fromMagnitude(subtractMagnitudes(b, a), rightNegative);
+}
+
+BigInt operator+(const BigInt &left, const BigInt &right) {
+    return BigInt::addSigned(left, right, false);
+}
+
+BigInt operator-(const BigInt &left, const BigInt &right) {
+    return BigInt::addSigned(left, right, true);
+}
+
+BigInt operator*(const BigInt &left, const BigInt &right) {
+    if (left.limbs.empty() && right.limbs.empty()) {
+        std::int64_t result = 0;
+        if (!__builtin_mul_overflow(left.small, right.small, &result)) return {result};
+    }
+    return BigInt::fromMagnitude(BigInt::multiplyMagnitudes(left.magnitude(), right.magnitude()),
+                                         (left.sign() < 0) != (right.sign() < 0));
+}
+
+/**
+ * Truncating division: the quotient is rounded toward zero and the remainder takes the sign of the dividend,
+ * as with the built-in integer operators.
+ * @throws std::runtime_error If the divisor is 0.
+ */
+void BigInt::divMod(const BigInt &dividend, const BigInt &divisor, BigInt &quotient, BigInt &remainder) {
+    if (divisor.isZero()) throw std::runtime_error("Division by 0 is not defined.");
+    if (dividend.limbs.empty() && divisor.limbs.empty() &&
+        !(dividend.small == std::numeric_limits<std::int64_t>::min() && divisor.small == -1)) {
+        std::int64_t q = dividend.small / divisor.small;
+        std::int64_t r = dividend.small % divisor.small;
+        quotient = BigInt(q);
+        remainder = BigInt(r);
+        return;
+    }
+    Limbs q;
+    Limbs r;
+    divModMagnitudes(dividend.magnitude(scratch()), divisor.magnitude(scratch()), q, r);
+    bool dividendNegative = dividend.sign() < 0;
+    quotient = fromMagnitude(std::move(q), dividendNegative != (divisor.sign() < 0));
+    remainder = fromMagnitude(std::move(r), dividendNegative);
+}
+
+BigInt operator/(const BigInt &left, const BigInt &right) {
+    BigInt quotient;
+    BigInt remainder;
+    BigInt::divMod(left, right, quotient, remainder);
+    return quotient;
+}
+
+BigInt operator%(const BigInt &left, const BigInt &right) {
+    BigInt quotient;
+    BigInt remainder;
+    BigInt::divMod(left, right, quotient, remainder);
+    return remainder;
+}
+
+BigInt &BigInt::operator+=(const BigInt &other) {
+    return *this = *this + other;
+}
+
+BigInt &BigInt::operator-=(const BigInt &other) {
+    return *this = *this - other;
+}
+
+BigInt &BigInt::operator*=(const BigInt &other) {
+    return *this = *this * other;
+}
+
+BigInt &BigInt::operator/=(const BigInt &other) {
+    return *this = *this / other;
+}
+
+/**
+ * Unimodular 2x2 matrix M with (a, b) = M (a', b'), recording the Euclid steps that took a pair (a, b) to (a', b').
+ */
+struct BigInt::GcdMatrix {
+    BigInt m00 = 1;
+    BigInt m01 = 0;
+    BigInt m10 = 0;
+    BigInt m11 = 1;
+    int determinant = 1;
+
+    /**
+     * Appends a division step (a, b) -> (b, a - q b).
+     */
+    void appendQuotient(const BigInt &q) {
+        BigInt next0 = m00 * q + m01;
+        m01 = std::move(m00);
+        m00 = std::move(next0);
+        BigInt next1 = m10 * q + m11;
+        m11 = std::move(m10);
+        m10 = std::move(next1);
+        determinant = -determinant;
+    }
+
+    /**
+     * Appends the steps (a, b) -> (x0 a + x1 b, x2 a + x3 b) found by lehmerCofactors, by multiplying with the inverse
+     * of their matrix. Only for matrices of genuine Euclid steps, whose entries stay non-negative.
+     */
+    void appendCofactors(const std::array<std::int64_t, 4> &x) {
+        std::int64_t sign = static_cast<__int128>(x[0]) * x[3] - static_cast<__int128>(x[1]) * x[2] > 0 ? 1 : -1;
+        Limbs first = m00.magnitude();
+        Limbs second = m01.magnitude();
+        m00 = fromMagnitude(combineMagnitudes(first, second, sign * x[3], -sign * x[2]), false);
+        m01 = fromMagnitude(combineMagnitudes(first, second, -sign * x[1], sign * x[0]), false);
+        first = m10.magnitude();
+        second = m11.magnitude();
+        m10 = fromMagnitude(combineMagnitudes(first, second, sign * x[3], -sign * x[2]), false);
+        m11 = fromMagnitude(combineMagnitudes(first, second, -sign * x[1], sign * x[0]), false);
+        determinant *= static_cast<int>(sign);
+    }
+
+    /**
+     * Appends the steps recorded by other.
+     */
+    void append(const GcdMatrix &other) {
+        BigInt next00 = m00 * other.m00 + m01 * other.m10;
+        BigInt next01 = m00 * other.m01 + m01 * other.m11;
+        BigInt next10 = m10 * other.m00 + m11 * other.m10;
+        BigInt next11 = m10 * other.m01 + m11 * other.m11;
+        m00 = std::move(next00);
+        m01 = std::move(next01);
+        m10 = std::move(next10);
+        m11 = std::move(next11);
+        determinant *= other.determinant;
+    }
+
+    /**
+     * Replaces (a, b) with M^-1 (a, b), where M was found by reducing the parts of a and b above bit split to
+     * (highA, highB): M^-1 (a, b) is (highA, highB) shifted back up plus M^-1 applied to the low parts alone, which
+     * multiplies the matrix by split-bit numbers instead of the full ones. M only looked at the leading bits, so the
+     * result may come out negative or out of order; it is then made non-negative and ordered, and M adjusted to match,
+     * which keeps it unimodular and therefore keeps gcd(a, b).
+     */
+    void reduce(BigInt &a, BigInt &b, const BigInt &highA, const BigInt &highB, std::size_t split) {
+        BigInt lowA = fromMagnitude(lowBits(a.magnitude(), split), false);
+        BigInt lowB = fromMagnitude(lowBits(b.magnitude(), split), false);
+        BigInt nextA = m11 * lowA - m01 * lowB;
+        BigInt nextB = m00 * lowB - m10 * lowA;
+        if (determinant < 0) {
+            nextA = -nextA;
+            nextB = -nextB;
+        }
+        nextA += fromMagnitude(shiftLeftMagnitude(highA.magnitude(), split), false);
+        nextB += fromMagnitude(shiftLeftMagnitude(highB.magnitude(), split), false);
+        if (nextA.sign() < 0) {
+            nextA = -nextA;
+            m00 = -m00;
+            m10 = -m10;
+            determinant = -determinant;
+        }
+        if (nextB.sign() < 0) {
+            nextB = -nextB;
+            m01 = -m01;
+            m11 = -m11;
+            determinant = -determinant;
+        }
+        if (nextA < nextB) {
+            std::swap(nextA, nextB);
+            std::swap(m00, m01);
+            std::swap(m10, m11);
+            determinant = -determinant;
+        }
+        a = std::move(nextA);
+        b = std::move(nextB);
+    }
+};
+
+/**
+ * Half-gcd (Thull and Yap; Moller): runs Euclid on a >= b >= 0 until b has at most half the bits of a, in time
+ * O(M(n) log n). The first half of the quotients is found recursively from the leading halves of a and b, which
+ * determine them; after one division step, the rest come from a second recursive call on the leading part of the
+ * reduced pair. Below HALF_GCD_BASE_LIMBS the quotients come from Lehmer steps.
+ * @return The steps taken; a and b are replaced by the reduced pair.
+ */
+BigInt::GcdMatrix BigInt::halfGcd(BigInt &a, BigInt &b) {
+    GcdMatrix steps;
+    std::size_t target = a.bitLength() / 2 + 1;
+    if (b.bitLength() <= target) return steps;
+
+    if (a.limbCount() < HALF_GCD_BASE_LIMBS) {
+        Limbs u = a.magnitude(scratch());
+        Limbs v = b.magnitude(scratch());
+        while (magnitudeBits(v) > target) {
+            std::array<std::int64_t, 4> cofactors{};
+            if (lehmerCofactors(u, v, cofactors)) {
+                Limbs next = combineMagnitudes(u, v, cofactors[0], cofactors[1]);
+                v = combineMagnitudes(u, v, cofactors[2], cofactors[3]);
+                u = std::move(next);
+                steps.appendCofactors(cofactors);
+            } else {
+                Limbs quotient;
+                Limbs remainder(scratch());
+                divModMagnitudes(u, v, quotient, remainder);
+                u = std::move(v);
+                v = std::move(remainder);
+                steps.appendQuotient(fromMagnitude(std::move(quotient), false));
+            }
+        }
+        a = fromMagnitude(std::move(u), false);
+        b = fromMagnitude(std::move(v), false);
+        return steps;
+    }
+
+    std::size_t split = a.bitLength() / 2;
+    BigInt highA = fromMagnitude(shiftRightMagnitude(a.magnitude(), split), false);
+    BigInt highB = fromMagnitude(shiftRightMagnitude(b.magnitude(), split), false);
+    steps = halfGcd(highA, highB);
+    steps.reduce(a, b, highA, highB, split);
+    if (b.bitLength() <= target) return steps;
+
+    BigInt quotient;
+    BigInt remainder;
+    divMod(a, b, quotient, remainder);
+    a = std::move(b);
+    b = std::move(remainder);
+    steps.appendQuotient(quotient);
+    if (b.bitLength() <= target || a.bitLength() >= 2 * target) return steps;
+
+    // Reducing the leading 2 (bits(a) - target) bits to half their length leaves b with about target bits.
+    split = 2 * target - a.bitLength();
+    highA = fromMagnitude(shiftRightMagnitude(a.magnitude(), split), false);
+    highB = fromMagnitude(shiftRightMagnitude(b.magnitude(), split), false);
+    GcdMatrix second = halfGcd(highA, highB);
+    second.reduce(a, b, highA, highB, split);
+    steps.append(second);
+    return steps;
+}
+
+/**
+ * Lehmer's gcd of magnitudes: each pass replaces a and b by combinations with single-word cofactors that advance
+ * Euclid by up to about 30 bits, falling back to a division step when the leading bits do not determine a quotient.
+ */
+BigInt BigInt::gcdLehmer(Limbs a, Limbs b) {
+    if (compareMagnitudes(a, b) < 0) std::swap(a, b);
+    while (a.size() > 2 && !b.empty()) {
+        std::array<std::int64_t, 4> cofactors{};
+        if (a.size() - b.size() <= 1 && lehmerCofactors(a, b, cofactors)) {
+            Limbs next = combineMagnitudes(a, b, cofactors[0], cofactors[1]);
+            b = combineMagnitudes(a, b, cofactors[2], cofactors[3]);
+            a = std::move(next);
+        } else {
+            Limbs quotient(scratch());
+            Limbs remainder(scratch());
+            divModMagnitudes(a, b, quotient, remainder);
+            a = std::move(b);
+            b = std::move(remainder);
+        }
+    }
+    if (b.empty()) return fromMagnitude(std::move(a), false);
+    return fromUnsigned(std::gcd(bitsAt(a, 0), bitsAt(b, 0)));
+}
+
+/**
+ * Greatest common divisor. Inline values use the machine gcd, operands below the half-gcd threshold Lehmer's
+ * algorithm, and larger ones are first brought below the threshold by repeated half-gcd reductions, each followed by
+ * a division step.
+ * @return The non-negative gcd, 0 only when both arguments are 0.
+ */
+BigInt BigInt::gcd(const BigInt &first, const BigInt &second) {
+    if (first.limbs.empty() && second.limbs.empty()) {
+        return fromUnsigned(std::gcd(magnitude64(first.small), magnitude64(second.small)));
+    }
+    BigInt a = first.abs();
+    BigInt b = second.abs();
+    if (a < b) std::swap(a, b);
+    while (b.limbCount() >= halfGcdLimbs.load(std::memory_order_relaxed)) {
+        halfGcd(a, b);
+        if (b.isZero()) return a;
+        BigInt rest = a % b;
+        a = std::move(b);
+        b = std::move(rest);
+    }
+    return gcdLehmer(a.magnitude(scratch()), b.magnitude(scratch()));
+}
+
+/**
+ * Sets the operand length, in 32-bit limbs, from which gcd uses half-gcd reductions instead of Lehmer's algorithm;
+ * at least 4. Intended for tuning; the default comes from the big_gcd benchmarks.
+ */
+void BigInt::setHalfGcdThreshold(std::size_t halfGcd) {
+    halfGcdLimbs.store(std::max<std::size_t>(halfGcd, 4), std::memory_order_relaxed);
+}
+
+std::size_t BigInt::halfGcdThreshold() {
+    return halfGcdLimbs.load(std::memory_order_relaxed);
+}
+
+/**
+ * @return A negative number, zero or a positive number as left is below, equal to or above right.
+ */
+int BigInt::compare(const BigInt &left, const BigInt &right) {
+    if (left.limbs.empty() && right.limbs.empty()) {
+        return left.small < right.small ? -1 : (left.small > right.small ? 1 : 0);
+    }
+    int leftSign = left.sign();
+    int rightSign = right.sign();
+    if (leftSign != rightSign) return leftSign < rightSign ? -1 : 1;
+    int order = compareMagnitudes(left.magnitude(), right.magnitude());
+    return leftSign < 0 ? -order : order;
+}
+
+bool operator==(const BigInt &left, const BigInt &right) {
+    return left.small == right.small && left.negative == right.negative && left.limbs == right.limbs;
+}
+
+bool operator!=(const BigInt &left, const BigInt &right) {
+    return !(left == right);
+}
+
+bool operator<(const BigInt &left, const BigInt &right) {
+    return BigInt::compare(left, right) < 0;
+}
+
+bool operator>(const BigInt &left, const BigInt &right) {
+    return BigInt::compare(left, right) > 0;
+}
+
+bool operator<=(const BigInt &left, const BigInt &right) {
+    return BigInt::compare(left, right) <= 0;
+}
+
+bool operator>=(const BigInt &left, const BigInt &right) {
+    return BigInt::compare(left, right) >= 0;
+}
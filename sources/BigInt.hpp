@@ -0,0 +1,143 @@
+#ifndef FRACTION_BIG_INT_HPP
+#define FRACTION_BIG_INT_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "LimbArena.hpp"
+
+/**
+ * Arbitrary-precision signed integer backing BigFraction.
+ *
+ * Values that fit in 64 bits are stored inline and handled with overflow-checked machine arithmetic, without touching
+ * the heap. Larger values spill to a sign and a little-endian vector of 32-bit limbs. The representation is canonical:
+ * a value is stored in limbs exactly when it does not fit in an int64_t, so equal values compare equal field by field.
+ *
+ * The limbs of a value always come from the global heap. The temporaries of multiplication, division and gcd come
+ * from the calling thread's LimbArena while an ArenaScope is active.
+ */
+class BigInt {
+
+public:
+
+    using Limbs = std::vector<std::uint32_t, LimbAllocator<std::uint32_t>>;
+
+private:
+
+    std::int64_t small = 0;
+    bool negative = false;
+    Limbs limbs;
+
+    static BigInt fromMagnitude(Limbs magnitude, bool negative);
+
+    static BigInt fromUnsigned(std::uint64_t value);
+
+    [[nodiscard]] Limbs magnitude(const Limbs::allocator_type &allocator = Limbs::allocator_type()) const;
+
+    static BigInt addSigned(const BigInt &left, const BigInt &right, bool negateRight);
+
+    static Limbs multiplyMagnitudes(const Limbs &a, const Limbs &b);
+
+    static Limbs multiplyKaratsuba(const Limbs &a, const Limbs &b);
+
+    static Limbs multiplyToom3(const Limbs &a, const Limbs &b);
+
+    struct GcdMatrix;
+
+    static GcdMatrix halfGcd(BigInt &a, BigInt &b);
+
+    static BigInt gcdLehmer(Limbs a, Limbs b);
+
+public:
+
+    static constexpr std::size_t DEFAULT_KARATSUBA_THRESHOLD = 48;
+
+    static constexpr std::size_t DEFAULT_TOOM3_THRESHOLD = 192;
+
+    static constexpr std::size_t DEFAULT_HALF_GCD_THRESHOLD = 2048;
+
+    BigInt();
+
+    BigInt(std::int64_t value);
+
+    BigInt(const BigInt &other);
+
+    BigInt(BigInt &&other);
+
+    BigInt &operator=(const BigInt &other);
+
+    BigInt &operator=(BigInt &&other);
+
+    [[nodiscard]] bool isSmall() const;
+
+    [[nodiscard]] bool isZero() const;
+
+    [[nodiscard]] int sign() const;
+
+    [[nodiscard]] bool fitsInt64() const;
+
+    [[nodiscard]] std::int64_t toInt64() const;
+
+    [[nodiscard]] std::size_t bitLength() const;
+
+    [[nodiscard]] std::size_t limbCount() const;
+
+    [[nodiscard]] BigInt abs() const;
+
+    [[nodiscard]] std::string toString() const;
+
+    static void divMod(const BigInt &dividend, const BigInt &divisor, BigInt &quotient, BigInt &remainder);
+
+    static BigInt gcd(const BigInt &first, const BigInt &second);
+
+    static void setMultiplyThresholds(std::size_t karatsuba, std::size_t toom3);
+
+    static std::size_t karatsubaThreshold();
+
+    static std::size_t toom3Threshold();
+
+    static void setHalfGcdThreshold(std::size_t halfGcd);
+
+    static std::size_t halfGcdThreshold();
+
+    friend std::ostream &operator<<(std::ostream &outstream, const BigInt &value);
+
+    BigInt operator-() const;
+
+    friend BigInt operator+(const BigInt &left, const BigInt &right);
+
+    friend BigInt operator-(const BigInt &left, const BigInt &right);
+
+    friend BigInt operator*(const BigInt &left, const BigInt &right);
+
+    friend BigInt operator/(const BigInt &left, const BigInt &right);
+
+    friend BigInt operator%(const BigInt &left, const BigInt &right);
+
+    BigInt &operator+=(const BigInt &other);
+
+    BigInt &operator-=(const BigInt &other);
+
+    BigInt &operator*=(const BigInt &other);
+
+    BigInt &operator/=(const BigInt &other);
+
+    friend bool operator==(const BigInt &left, const BigInt &right);
+
+    friend bool operator!=(const BigInt &left, const BigInt &right);
+
+    friend bool operator<(const BigInt &left, const BigInt &right);
+
+    friend bool operator>(const BigInt &left, const BigInt &right);
+
+    friend bool operator<=(const BigInt &left, const BigInt &right);
+
+    friend bool operator>=(const BigInt &left, const BigInt &right);
+
+    static int compare(const BigInt &left, const BigInt &right);
+};
+
+#endif
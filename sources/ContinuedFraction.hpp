@@ -0,0 +1,75 @@
+#ifndef FRACTION_CONTINUED_FRACTION_HPP
+#define FRACTION_CONTINUED_FRACTION_HPP
+
+#include <utility>
+
+/**
+ * The closest fractions with denominators up to a bound on either side of a value, as magnitudes (p, q).
+ *
+ * Once the next convergent's denominator would exceed the bound, the current convergent and the semiconvergent with the
+ * largest admissible step t lie on opposite sides of the value. Their determinant is 1, so every fraction strictly
+ * between them has a denominator larger than the sum of theirs, which exceeds the bound. When the value's reduced
+ * denominator is within the bound, both candidates are the value itself.
+ */
+template<class Word>
+struct ContinuedFractionBracket {
+
+    std::pair<Word, Word> convergent;
+
+    std::pair<Word, Word> semiconvergent;
+
+    bool convergentAbove = false;
+
+    /**
+     * The sign of 2t - a, where a is the continued fraction term the step t falls short of: the semiconvergent is the
+     * closer candidate when it is positive and the farther one when it is negative; 0 needs a direct comparison.
+     */
+    int semiconvergentCloser = 0;
+
+    [[nodiscard]] const std::pair<Word, Word> &below() const {
+        return convergentAbove ? semiconvergent : convergent;
+    }
+
+    [[nodiscard]] const std::pair<Word, Word> &above() const {
+        return convergentAbove ? convergent : semiconvergent;
+    }
+};
+
+/**
+ * Walks the continued fraction of n/d and returns the candidates with denominators up to bound on either side of it.
+ * Word is wide enough for n and d; every term stays below max(n, d), and a step is only taken once it is known to keep
+ * q within bound, so no product overflows.
+ */
+template<class Word>
+ContinuedFractionBracket<Word> bracketContinuedFraction(Word n, Word d, Word bound) {
+    Word p0 = 0, q0 = 1, p1 = 1, q1 = 0;
+    // Convergents alternate sides of n/d; the initial 1/0 lies above it.
+    bool convergentAbove = true;
+    while (d != 0) {
+        Word a = n / d;
+        if (q1 != 0 && a > (bound - q0) / q1) {
+            Word t = (bound - q0) / q1;
+            ContinuedFractionBracket<Word> result;
+            result.convergent = {p1, q1};
+            result.semiconvergent = {p0 + t * p1, q0 + t * q1};
+            result.convergentAbove = convergentAbove;
+            result.semiconvergentCloser = (t > a - t) - (t < a - t);
+            return result;
+        }
+        Word p2 = a * p1 + p0;
+        Word q2 = a * q1 + q0;
+        p0 = p1;
+        q0 = q1;
+        p1 = p2;
+        q1 = q2;
+        convergentAbove = !convergentAbove;
+        Word rest = n - a * d;
+        n = d;
+        d = rest;
+    }
+    ContinuedFractionBracket<Word> result;
+    result.convergent = result.semiconvergent = {p1, q1};
+    return result;
+}
+
+#endif
@@ -1,4 +1,27 @@
 #include "Fraction.hpp"
+#include "ContinuedFraction.hpp"
+#include "FractionStats.hpp"
+
+#include <array>
+#include <bit>
+#include <cmath>
+#include <cstdint>
+#include <utility>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+/**
+ * Greatest common divisor used by every Fraction operation, counted as FractionCounter::Gcd when FRACTION_STATS is on.
+ * @param a The first integer.
+ * @param b The second integer.
+ * @return The greatest common divisor of the two integers, as returned by std::__gcd.
+ */
+static int gcd_ints(int a, int b) {
+    FRACTION_COUNT(Gcd);
+    return __gcd(a, b);
+}
 
 /**
  * Calculates the least common multiple (LCM) of two fractions.
@@ -6,31 +29,296 @@
  * @return The LCM of the two fractions.
  */
 int Fraction::lcm(const Fraction &other) const {
-    int lcm = (denominator * other.getDenominator()) / __gcd(denominator, other.getDenominator());
+    int lcm = (denominator * other.getDenominator()) / gcd_ints(denominator, other.getDenominator());
     int num1 = numerator;
     num1 *= (lcm / denominator);
     int num2 = other.getNumerator();
     num2 *= lcm / other.getDenominator();
 
     int sum_num = num1 + num2;
-    int gcd = __gcd(sum_num, lcm);
+    int gcd = gcd_ints(sum_num, lcm);
     lcm /= gcd;
     return lcm;
 }
 
+/**
+ * gcd(k, 1000) for every k in [0, 1000), with gcd(0, 1000) = 1000.
+ * A float is converted through its thousandths t = 1000 * whole + k, and gcd(t, 1000) = gcd(k, 1000), so this table
+ * replaces the gcd of the conversion. It is constant-initialised, so Fractions converted during the static
+ * initialisation of other translation units can already use it.
+ */
+static constexpr std::array<int, 1000> THOUSANDTHS_GCD = []() constexpr {
+    std::array<int, 1000> table{};
+    for (int k = 0; k < 1000; ++k) {
+        int a = k;
+        int b = 1000;
+        while (a != 0) {
+            int rest = b % a;
+            b = a;
+            a = rest;
+        }
+        table[static_cast<std::size_t>(k)] = b;
+    }
+    return table;
+}();
+
+/**
+ * Truncates a float to whole thousandths, keeping its sign.
+ */
+static int floatToThousandths(float x) {
+    int sign = x < 0 ? -1 : 1;
+    return static_cast<int>(std::abs(x) * 1000.0f) * sign;
+}
+
+/**
+ * Builds the reduced Fraction thousandths/1000 by splitting off the whole part and looking the gcd of the
+ * remainder up in THOUSANDTHS_GCD.
+ */
+static Fraction thousandthsToFraction(int thousandths) {
+    int magnitude = std::abs(thousandths);
+    int whole = magnitude / 1000;
+    int rest = magnitude % 1000;
+    int gcd = THOUSANDTHS_GCD[static_cast<std::size_t>(rest)];
+    int denominator = 1000 / gcd;
+    int numerator = whole * denominator + rest / gcd;
+    return Fraction::fromReduced(thousandths < 0 ? -numerator : numerator, denominator);
+}
+
 /**
  * Converts a float value to a Fraction object.
- * Multiplies the float value by 1000 to obtain a more accurate representation of the fraction, and then creates a Fraction object with the resulting numerator and denominator of 1000.
+ * Truncates the float value to whole thousandths, so the result is the value up to 3 digits beyond the decimal point, reduced.
+ * The gcd of the reduction comes from a precomputed table of gcd(k, 1000), so no gcd is computed.
  * The sign of the float value is preserved in the resulting Fraction object.
  * @param x The float value to convert to a Fraction object.
  * @return A Fraction object representing the given float value.
  */
 Fraction Fraction::floatToFraction(float x) {
-    int sign = x < 0 ? -1 : 1;
-    x = std::abs(x) * 1000.0f;
-    int intVal = static_cast<int>(x);
-    Fraction result = {intVal * sign, 1000};
-    return result;
+    FRACTION_COUNT(FloatConversion);
+    return thousandthsToFraction(floatToThousandths(x));
+}
+
+/**
+ * Converts an array of float values with floatToFraction.
+ * The values are first truncated to thousandths in a separate loop that the compiler can vectorise, then reduced
+ * through the gcd table.
+ * @param values The float values to convert.
+ * @param count The number of values.
+ * @param results The array receiving the count converted Fractions.
+ */
+void Fraction::floatsToFractions(const float *values, std::size_t count, Fraction *results) {
+    const std::size_t block = 256;
+    std::array<int, block> thousandths{};
+    for (std::size_t first = 0; first < count; first += block) {
+        std::size_t size = std::min(block, count - first);
+        for (std::size_t i = 0; i < size; ++i) {
+            float value = values[first + i];
+            float scaled = std::abs(value) * 1000.0f;
+            int magnitude = static_cast<int>(scaled);
+            thousandths[i] = value < 0 ? -magnitude : magnitude;
+        }
+        for (std::size_t i = 0; i < size; ++i) {
+            FRACTION_COUNT(FloatConversion);
+            results[first + i] = thousandthsToFraction(thousandths[i]);
+        }
+    }
+}
+
+/**
+ * @return The best rational approximation p/q of n/d with q <= bound, as the magnitude (p, q) of the result: the
+ * closer of the two candidates that bracket it.
+ */
+template<class Word>
+static std::pair<Word, Word> bestApproximation(Word n, Word d, Word bound, long double magnitude) {
+    ContinuedFractionBracket<Word> bracket = bracketContinuedFraction(n, d, bound);
+    if (bracket.semiconvergentCloser != 0 || bracket.semiconvergent == bracket.convergent) {
+        return bracket.semiconvergentCloser > 0 ? bracket.semiconvergent : bracket.convergent;
+    }
+    auto error = [magnitude](const std::pair<Word, Word> &candidate) {
+        return std::fabs(magnitude - static_cast<long double>(candidate.first) /
+                                     static_cast<long double>(candidate.second));
+    };
+    return error(bracket.semiconvergent) < error(bracket.convergent) ? bracket.semiconvergent : bracket.convergent;
+}
+
+/**
+ * Converts a floating-point value to the closest Fraction whose denominator does not exceed maxDenominator.
+ * The value is expanded exactly into a dyadic rational and walked through its continued fraction, so the result is the
+ * best rational approximation: no fraction with a denominator up to maxDenominator lies closer to the value.
+ * With the default bound, decimals with up to 3 digits beyond the decimal point convert exactly, the accuracy the
+ * float overloads provide, but without rounding the value through float first.
+ * @param value The value to convert.
+ * @param maxDenominator The largest denominator the result may have.
+ * @throws std::invalid_argument If the value is NaN or maxDenominator is not positive.
+ * @throws std::overflow_error If the result does not fit in an int.
+ * @return The best approximation of the value.
+ */
+Fraction Fraction::approximate(long double value, int maxDenominator) {
+    if (maxDenominator <= 0) throw invalid_argument("Denominator bound must be positive");
+    if (std::isnan(value)) throw invalid_argument("NaN");
+    FRACTION_COUNT(FloatConversion);
+    long double magnitude = std::fabs(value);
+    if (!(magnitude < 2147483648.0L)) throw std::overflow_error("Integer overflow");
+    if (magnitude * 2.0L * static_cast<long double>(maxDenominator) <= 1.0L) return {};
+
+    // magnitude == n / d exactly, with d a power of two. Values that are doubles no smaller than 2^-10 fit the
+    // expansion in 64 bits; anything else takes the 128-bit path, where n is below 2^64 and d at most 2^96.
+    std::pair<std::uint64_t, std::uint64_t> result;
+    auto narrow = static_cast<double>(magnitude);
+    int exponent = 0;
+    if (narrow == magnitude && narrow >= 0x1p-10) {
+        auto n = static_cast<std::uint64_t>(std::ldexp(std::frexp(narrow, &exponent), 53));
+        std::uint64_t d = std::uint64_t{1} << static_cast<unsigned>(53 - exponent);
+        result = bestApproximation<std::uint64_t>(n, d, static_cast<std::uint64_t>(maxDenominator), magnitude);
+    } else {
+        auto n = static_cast<unsigned __int128>(std::ldexp(std::frexp(magnitude, &exponent), 64));
+        unsigned __int128 d = static_cast<unsigned __int128>(1) << static_cast<unsigned>(64 - exponent);
+        std::pair<unsigned __int128, unsigned __int128> wide =
+                bestApproximation<unsigned __int128>(n, d, static_cast<unsigned __int128>(maxDenominator), magnitude);
+        result = {static_cast<std::uint64_t>(wide.first), static_cast<std::uint64_t>(wide.second)};
+    }
+
+    if (result.first > static_cast<std::uint64_t>(std::numeric_limits<int>::max())) throw std::overflow_error("Integer overflow");
+    int numerator = static_cast<int>(result.first);
+    return fromReduced(value < 0 ? -numerator : numerator, static_cast<int>(result.second));
+}
+
+/**
+ * Converts a double to the Fraction equal to it, without any rounding.
+ * Every finite double is a dyadic rational, so this succeeds exactly when the reduced numerator fits in an int and the
+ * denominator is a power of two no larger than 2^30.
+ * @param value The value to convert.
+ * @throws std::invalid_argument If the value is NaN.
+ * @throws std::overflow_error If the value is infinite or its exact fraction does not fit in an int.
+ * @return The Fraction equal to the value.
+ */
+Fraction Fraction::exactFromDouble(double value) {
+    if (std::isnan(value)) throw invalid_argument("NaN");
+    FRACTION_COUNT(FloatConversion);
+    if (value == 0) return {};
+    double magnitude = std::fabs(value);
+    if (!(magnitude < 2147483648.0)) throw std::overflow_error("Integer overflow");
+
+    // magnitude == mantissa * 2^-shift with an odd mantissa.
+    int exponent = 0;
+    auto mantissa = static_cast<std::uint64_t>(std::ldexp(std::frexp(magnitude, &exponent), 53));
+    int zeros = __builtin_ctzll(mantissa);
+    mantissa >>= static_cast<unsigned>(zeros);
+    int shift = 53 - exponent - zeros;
+    if (shift > 30) throw std::overflow_error("Integer overflow");
+    if (shift < 0) {
+        mantissa <<= static_cast<unsigned>(-shift);
+        shift = 0;
+    }
+    if (mantissa > static_cast<std::uint64_t>(std::numeric_limits<int>::max())) throw std::overflow_error("Integer overflow");
+    int numerator = static_cast<int>(mantissa);
+    return fromReduced(value < 0 ? -numerator : numerator, 1 << static_cast<unsigned>(shift));
+}
+
+/**
+ * Converts the Fraction to the nearest double.
+ * Integers and power-of-two denominators are converted exactly without a division; otherwise the numerator and
+ * denominator are both exact doubles, so a single division yields the correctly rounded result.
+ * @return The value of the Fraction as a double.
+ */
+double Fraction::to_double() const {
+    if (denominator == 1) return numerator;
+    if ((denominator & (denominator - 1)) == 0) return std::ldexp(static_cast<double>(numerator), -__builtin_ctz(static_cast<unsigned>(denominator)));
+    return static_cast<double>(numerator) / denominator;
+}
+
+/**
+ * Rounds n/d to the nearest float, ties to even, using integer arithmetic only.
+ * The numerator is shifted to fill 64 bits, so the quotient carries at least 32 significant bits and the remainder
+ * acts as the sticky bit below them.
+ * @param n The numerator magnitude, not 0.
+ * @param d The denominator.
+ * @return The correctly rounded magnitude of n/d.
+ */
+[[gnu::noinline]] static float roundQuotientToFloat(std::uint64_t n, std::uint64_t d) {
+    auto shift = static_cast<unsigned>(__builtin_clzll(n));
+    std::uint64_t scaled = n << shift;
+    std::uint64_t quotient = scaled / d;
+    std::uint64_t remainder = scaled % d;
+    auto dropped = static_cast<unsigned>(63 - __builtin_clzll(quotient) - 23);
+    std::uint64_t mantissa = quotient >> dropped;
+    std::uint64_t rest = quotient & ((std::uint64_t{1} << dropped) - 1);
+    std::uint64_t half = std::uint64_t{1} << (dropped - 1);
+    if (rest > half || (rest == half && (remainder != 0 || (mantissa & 1U) != 0))) ++mantissa;
+    return std::ldexp(static_cast<float>(mantissa), static_cast<int>(dropped) - static_cast<int>(shift));
+}
+
+/**
+ * @return True if the double lies exactly halfway between two adjacent floats, the only case in which rounding a
+ * correctly rounded double quotient to float can differ from rounding the exact quotient.
+ */
+static bool isFloatMidpoint(double value) {
+    return (std::bit_cast<std::uint64_t>(value) & 0x1FFFFFFFU) == 0x10000000U;
+}
+
+/**
+ * Narrows the correctly rounded double quotient of a Fraction to float, recomputing the rare midpoint cases exactly.
+ */
+static float narrowQuotient(double quotient, int numerator, int denominator) {
+    if (!isFloatMidpoint(quotient)) [[likely]] return static_cast<float>(quotient);
+    float magnitude = roundQuotientToFloat(static_cast<std::uint64_t>(std::abs(static_cast<std::int64_t>(numerator))),
+                                           static_cast<std::uint64_t>(denominator));
+    return numerator < 0 ? -magnitude : magnitude;
+}
+
+/**
+ * Converts the Fraction to the nearest float.
+ * Numerators and denominators above 2^24 are not exact floats, so dividing them in float would round three times.
+ * Instead the quotient is computed as a correctly rounded double and narrowed: a float boundary strictly between the
+ * exact quotient and that double would itself be a closer double, so the narrowing can only go wrong when the double
+ * is exactly a float midpoint, which is recomputed with integer arithmetic.
+ * @return The value of the Fraction as a float.
+ */
+float Fraction::to_float() const {
+    return narrowQuotient(static_cast<double>(numerator) / denominator, numerator, denominator);
+}
+
+/**
+ * Converts an array of Fractions to doubles, giving the same results as to_double.
+ * With SSE2, two Fractions are loaded at once, their numerators and denominators separated with a shuffle, and
+ * divided as a pair.
+ * @param fractions The Fractions to convert.
+ * @param count The number of Fractions.
+ * @param results The array receiving the count doubles.
+ */
+void Fraction::toDoubles(const Fraction *fractions, std::size_t count, double *results) {
+    std::size_t i = 0;
+#if defined(__SSE2__)
+    for (; i + 2 <= count; i += 2) {
+        __m128i pair = _mm_loadu_si128(reinterpret_cast<const __m128i *>(fractions + i));
+        __m128i split = _mm_shuffle_epi32(pair, _MM_SHUFFLE(3, 1, 2, 0));
+        __m128d numerators = _mm_cvtepi32_pd(split);
+        __m128d denominators = _mm_cvtepi32_pd(_mm_unpackhi_epi64(split, split));
+        _mm_storeu_pd(results + i, _mm_div_pd(numerators, denominators));
+    }
+#endif
+    for (; i < count; ++i) {
+        results[i] = static_cast<double>(fractions[i].numerator) / fractions[i].denominator;
+    }
+}
+
+/**
+ * Converts an array of Fractions to floats, giving the same results as to_float.
+ * The double quotients are computed a block at a time with toDoubles and then narrowed.
+ * @param fractions The Fractions to convert.
+ * @param count The number of Fractions.
+ * @param results The array receiving the count floats.
+ */
+void Fraction::toFloats(const Fraction *fractions, std::size_t count, float *results) {
+    const std::size_t block = 256;
+    std::array<double, block> quotients{};
+    for (std::size_t first = 0; first < count; first += block) {
+        std::size_t size = std::min(block, count - first);
+        toDoubles(fractions + first, size, quotients.data());
+        for (std::size_t i = 0; i < size; ++i) {
+            const Fraction &fraction = fractions[first + i];
+            results[first + i] = narrowQuotient(quotients[i], fraction.numerator, fraction.denominator);
+        }
+    }
 }
 
 /**
@@ -42,9 +330,11 @@ Fraction Fraction::floatToFraction(float x) {
  */
 int add_ints(int a, int b) {
     if (a > 0 && b > std::numeric_limits<int>::max() - a) {
+        FRACTION_COUNT(AddOverflow);
         throw std::overflow_error("Integer overflow");
     }
     if (a < 0 && b < std::numeric_limits<int>::min() - a) {
+        FRACTION_COUNT(AddOverflow);
         throw std::overflow_error("Integer underflow");
     }
     return a + b;
@@ -59,9 +349,11 @@ int add_ints(int a, int b) {
  */
 int sub_ints(int a, int b) {
     if (b < 0 && a > std::numeric_limits<int>::max() + b) {
+        FRACTION_COUNT(SubOverflow);
         throw std::overflow_error("Integer overflow");
     }
     if (b > 0 && a < std::numeric_limits<int>::min() + b) {
+        FRACTION_COUNT(SubOverflow);
         throw std::overflow_error("Integer underflow");
     }
     return a - b;
@@ -80,9 +372,11 @@ int sub_ints(int a, int b) {
 int mul_ints(int a, int b) {
 
     if (a > 0 && b > 0 && a > std::numeric_limits<int>::max() / b) {
+        FRACTION_COUNT(MulOverflow);
         throw std::overflow_error("Integer overflow");
     }
     if (a < 0 && b < 0 && a < std::numeric_limits<int>::max() / b) {
+        FRACTION_COUNT(MulOverflow);
         throw std::overflow_error("Integer overflow");
     }
     return a * b;
@@ -113,8 +407,11 @@ Fraction::Fraction(int n, int d) {
         throw invalid_argument("0");
     }
 
-    int sign = n * d < 0 ? -1 : 1;
-    int gcd = __gcd(n, d);
+    FRACTION_COUNT(Construction);
+    // d is positive here, so the sign is the numerator's; computing it as n * d could overflow.
+    int sign = n < 0 ? -1 : 1;
+    int gcd = gcd_ints(n, d);
+    if (gcd != 1 && gcd != -1) FRACTION_COUNT(Renormalisation);
     numerator = abs(n / gcd) * sign;
     denominator = abs(d / gcd);
 }
@@ -131,6 +428,22 @@ Fraction::Fraction(float f) {
     denominator = temp.getDenominator();
 }
 
+/**
+ * Builds a Fraction from parts that are already in reduced form, skipping the gcd and sign normalisation of the
+ * (int, int) constructor.
+ * The caller guarantees that the denominator is positive and that the numerator and denominator are coprime
+ * (the numerator is 0 only together with a denominator of 1).
+ * @param n The reduced numerator.
+ * @param d The reduced, positive denominator.
+ * @return A Fraction holding exactly the given parts.
+ */
+Fraction Fraction::fromReduced(int n, int d) {
+    Fraction result;
+    result.numerator = n;
+    result.denominator = d;
+    return result;
+}
+
 Fraction::Fraction() {
     numerator = 0;
     denominator = 1;
@@ -206,7 +519,7 @@ std::istream &operator>>(std::istream &in, Fraction &fraction) {
  */
 Fraction Fraction::operator+(const Fraction &other) const {
 
-    int lcm = (denominator * other.getDenominator()) / __gcd(denominator, other.getDenominator());
+    int lcm = (denominator * other.getDenominator()) / gcd_ints(denominator, other.getDenominator());
 
     int new_num1 = numerator * (lcm / denominator);
     int new_num2 = other.getNumerator() * (lcm / other.getDenominator());
@@ -227,7 +540,7 @@ Fraction Fraction::operator+(const Fraction &other) const {
  */
 Fraction Fraction::operator-(const Fraction &other) const {
 
-    int lcm = (denominator * other.getDenominator()) / __gcd(denominator, other.getDenominator());
+    int lcm = (denominator * other.getDenominator()) / gcd_ints(denominator, other.getDenominator());
 
     int new_num1 = numerator * (lcm / denominator);
     int new_num2 = other.getNumerator() * (lcm / other.getDenominator());
@@ -7,11 +7,18 @@
 #include <stdexcept>
 #include <algorithm>
 #include <limits>
+#include <concepts>
 
 using namespace std;
 
 namespace ariel {}
 
+/**
+ * The floating-point types that get their own Fraction overloads instead of narrowing to float.
+ */
+template<class T>
+concept WideFloatingPoint = std::same_as<T, double> || std::same_as<T, long double>;
+
 class Fraction {
 
 private:
@@ -19,6 +26,11 @@ private:
     int numerator;
     int denominator;
 
+    template<WideFloatingPoint T>
+    [[nodiscard]] T nearest() const {
+        return static_cast<T>(numerator) / static_cast<T>(denominator);
+    }
+
 public:
 
     Fraction();
@@ -29,6 +41,22 @@ public:
 
     static Fraction floatToFraction(float value);
 
+    static Fraction fromReduced(int numerator, int denominator);
+
+    static void floatsToFractions(const float *values, std::size_t count, Fraction *results);
+
+    static Fraction approximate(long double value, int maxDenominator = 1000);
+
+    static Fraction exactFromDouble(double value);
+
+    [[nodiscard]] double to_double() const;
+
+    [[nodiscard]] float to_float() const;
+
+    static void toDoubles(const Fraction *fractions, std::size_t count, double *results);
+
+    static void toFloats(const Fraction *fractions, std::size_t count, float *results);
+
     friend std::ostream &operator<<(std::ostream &outstream, const Fraction &fraction);
 
     friend std::istream &operator>>(std::istream &instream, Fraction &fraction);
@@ -39,60 +67,160 @@ public:
 
     friend Fraction operator+(float value, const Fraction &fraction);
 
+    template<WideFloatingPoint T>
+    Fraction operator+(T other) const {
+        return *this + approximate(other);
+    }
+
+    template<WideFloatingPoint T>
+    friend Fraction operator+(T value, const Fraction &fraction) {
+        return approximate(value) + fraction;
+    }
+
     Fraction operator-(const Fraction &other) const;
 
     Fraction operator-(float other) const;
 
     friend Fraction operator-(float value, const Fraction &fraction);
 
+    template<WideFloatingPoint T>
+    Fraction operator-(T other) const {
+        return *this - approximate(other);
+    }
+
+    template<WideFloatingPoint T>
+    friend Fraction operator-(T value, const Fraction &fraction) {
+        return approximate(value) - fraction;
+    }
+
     Fraction operator/(const Fraction &other) const;
 
     Fraction operator/(float other) const;
 
     friend Fraction operator/(float value, const Fraction &fraction);
 
+    template<WideFloatingPoint T>
+    Fraction operator/(T other) const {
+        return *this / approximate(other);
+    }
+
+    template<WideFloatingPoint T>
+    friend Fraction operator/(T value, const Fraction &fraction) {
+        return approximate(value) / fraction;
+    }
+
     Fraction operator*(const Fraction &other) const;
 
     Fraction operator*(float other) const;
 
     friend Fraction operator*(float value, const Fraction &fraction);
 
+    template<WideFloatingPoint T>
+    Fraction operator*(T other) const {
+        return *this * approximate(other);
+    }
+
+    template<WideFloatingPoint T>
+    friend Fraction operator*(T value, const Fraction &fraction) {
+        return approximate(value) * fraction;
+    }
+
     bool operator==(const Fraction &other) const;
 
     bool operator==(float other) const;
 
     friend bool operator==(float value, const Fraction &fraction);
 
+    template<WideFloatingPoint T>
+    bool operator==(T other) const {
+        return nearest<T>() == other;
+    }
+
+    template<WideFloatingPoint T>
+    friend bool operator==(T value, const Fraction &fraction) {
+        return value == fraction.nearest<T>();
+    }
+
     bool operator!=(const Fraction &other) const;
 
     bool operator!=(float other) const;
 
     friend bool operator!=(float value, const Fraction &fraction);
 
+    template<WideFloatingPoint T>
+    bool operator!=(T other) const {
+        return nearest<T>() != other;
+    }
+
+    template<WideFloatingPoint T>
+    friend bool operator!=(T value, const Fraction &fraction) {
+        return value != fraction.nearest<T>();
+    }
+
     bool operator>(const Fraction &other) const;
 
     bool operator>(float other) const;
 
     friend bool operator>(float value, const Fraction &fraction);
 
+    template<WideFloatingPoint T>
+    bool operator>(T other) const {
+        return nearest<T>() > other;
+    }
+
+    template<WideFloatingPoint T>
+    friend bool operator>(T value, const Fraction &fraction) {
+        return value > fraction.nearest<T>();
+    }
+
     bool operator<(const Fraction &other) const;
 
     bool operator<(float other) const;
 
     friend bool operator<(float value, const Fraction &fraction);
 
+    template<WideFloatingPoint T>
+    bool operator<(T other) const {
+        return nearest<T>() < other;
+    }
+
+    template<WideFloatingPoint T>
+    friend bool operator<(T value, const Fraction &fraction) {
+        return value < fraction.nearest<T>();
+    }
+
     bool operator>=(const Fraction &other) const;
 
     bool operator>=(float other) const;
 
     friend bool operator>=(float value, const Fraction &fraction);
 
+    template<WideFloatingPoint T>
+    bool operator>=(T other) const {
+        return nearest<T>() >= other;
+    }
+
+    template<WideFloatingPoint T>
+    friend bool operator>=(T value, const Fraction &fraction) {
+        return value >= fraction.nearest<T>();
+    }
+
     bool operator<=(const Fraction &other) const;
 
     bool operator<=(float other) const;
 
     friend bool operator<=(float value, const Fraction &fraction);
 
+    template<WideFloatingPoint T>
+    bool operator<=(T other) const {
+        return nearest<T>() <= other;
+    }
+
+    template<WideFloatingPoint T>
+    friend bool operator<=(T value, const Fraction &fraction) {
+        return value <= fraction.nearest<T>();
+    }
+
     Fraction& operator++();
 
     Fraction operator++(int);
@@ -114,5 +242,7 @@ public:
 
     int mul_ints(int first, int second);
 
+static_assert(sizeof(Fraction) == 2 * sizeof(int), "Fraction must stay a plain numerator/denominator pair");
+
 
 #endif
@@ -0,0 +1,144 @@
+#include "FractionCache.hpp"
+
+#include <algorithm>
+#include <cstring>
+
+#include "FractionHash.hpp"
+
+/**
+ * Packs a Fraction into a cache key with every zero as 0/1, matching Fraction::operator==.
+ */
+static std::uint64_t operandKey(const Fraction &fraction) {
+    int numerator = fraction.getNumerator();
+    return packFractionKey(numerator, numerator == 0 ? 1 : fraction.getDenominator());
+}
+
+static Fraction unpackResult(std::uint64_t key) {
+    return Fraction::fromReduced(static_cast<int>(static_cast<std::uint32_t>(key >> 32U)),
+                                 static_cast<int>(static_cast<std::uint32_t>(key)));
+}
+
+/**
+ * Creates an empty cache.
+ * @param capacity The total number of cached results, rounded up so that every shard has a power-of-two number of
+ * four-entry sets.
+ */
+FractionCache::FractionCache(std::size_t capacity) : setMask(0) {
+    std::size_t sets = 1;
+    while (sets * WAYS * SHARDS < capacity) sets <<= 1U;
+    setMask = sets - 1;
+    shards = std::make_unique<Shard[]>(SHARDS);
+    for (std::size_t i = 0; i < SHARDS; ++i) {
+        shards[i].entries.resize(sets * WAYS);
+        shards[i].hands.resize(sets);
+    }
+}
+
+/**
+ * Returns the cached result for the key, or computes, caches and returns it.
+ * The shard lock is not held while computing, so a slow or throwing computation never blocks other threads.
+ */
+template<class Compute>
+Fraction FractionCache::lookup(FractionOperation operation, std::uint64_t left, std::uint64_t right,
+                               Compute compute) {
+    std::uint64_t hash = mixFractionKey(left * 0x9e3779b97f4a7c15ULL ^ right ^ static_cast<std::uint64_t>(operation));
+    Shard &shard = shards[hash & (SHARDS - 1)];
+    std::size_t set = static_cast<std::size_t>(hash >> 4U) & setMask;
+    Entry *ways = shard.entries.data() + set * WAYS;
+    auto find = [ways, operation, left, right]() -> Entry * {
+        for (std::size_t way = 0; way < WAYS; ++way) {
+            Entry &entry = ways[way];
+            if (entry.valid && entry.left == left && entry.right == right && entry.operation == operation) {
+                return &entry;
+            }
+        }
+        return nullptr;
+    };
+
+    {
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        if (Entry *entry = find()) {
+            entry->referenced = true;
+            hits.fetch_add(1, std::memory_order_relaxed);
+            return unpackResult(entry->result);
+        }
+    }
+    misses.fetch_add(1, std::memory_order_relaxed);
+    Fraction result = compute();
+
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    // Another thread may have cached the same key while this one computed; a second copy would only evict an entry.
+    if (Entry *entry = find()) {
+        entry->referenced = true;
+        return result;
+    }
+    std::uint8_t &hand = shard.hands[set];
+    while (ways[hand].valid && ways[hand].referenced) {
+        ways[hand].referenced = false;
+        hand = static_cast<std::uint8_t>((hand + 1U) % WAYS);
+    }
+    Entry &victim = ways[hand];
+    if (victim.valid) evictions.fetch_add(1, std::memory_order_relaxed);
+    victim = {left, right, packFractionKey(result.getNumerator(), result.getDenominator()), operation, true, false};
+    hand = static_cast<std::uint8_t>((hand + 1U) % WAYS);
+    return result;
+}
+
+/**
+ * Cached Fraction::operator*. Multiplication commutes, so both operand orders share an entry.
+ * @throws std::overflow_error As Fraction::operator*.
+ */
+Fraction FractionCache::multiply(const Fraction &first, const Fraction &second) {
+    std::uint64_t left = operandKey(first);
+    std::uint64_t right = operandKey(second);
+    return lookup(FractionOperation::Multiply, std::min(left, right), std::max(left, right),
+                  [&first, &second] { return first * second; });
+}
+
+/**
+ * Cached Fraction::operator/.
+ * @throws std::runtime_error If the divisor is 0.
+ * @throws std::overflow_error As Fraction::operator/.
+ */
+Fraction FractionCache::divide(const Fraction &dividend, const Fraction &divisor) {
+    return lookup(FractionOperation::Divide, operandKey(dividend), operandKey(divisor),
+                  [&dividend, &divisor] { return dividend / divisor; });
+}
+
+/**
+ * Cached Fraction::floatToFraction, keyed on the bits of the float.
+ */
+Fraction FractionCache::floatToFraction(float value) {
+    std::uint32_t bits = 0;
+    std::memcpy(&bits, &value, sizeof(bits));
+    return lookup(FractionOperation::FloatConversion, bits, 0, [value] { return Fraction::floatToFraction(value); });
+}
+
+/**
+ * @return The hit, miss and eviction counts since construction or the last clear().
+ */
+FractionCacheStats FractionCache::stats() const {
+    FractionCacheStats result;
+    result.hits = hits.load(std::memory_order_relaxed);
+    result.misses = misses.load(std::memory_order_relaxed);
+    result.evictions = evictions.load(std::memory_order_relaxed);
+    return result;
+}
+
+std::size_t FractionCache::capacity() const {
+    return SHARDS * (setMask + 1) * WAYS;
+}
+
+/**
+ * Drops every cached result and zeroes the statistics.
+ */
+void FractionCache::clear() {
+    for (std::size_t i = 0; i < SHARDS; ++i) {
+        std::lock_guard<std::mutex> lock(shards[i].mutex);
+        std::fill(shards[i].entries.begin(), shards[i].entries.end(), Entry());
+        std::fill(shards[i].hands.begin(), shards[i].hands.end(), 0);
+    }
+    hits.store(0, std::memory_order_relaxed);
+    misses.store(0, std::memory_order_relaxed);
+    evictions.store(0, std::memory_order_relaxed);
+}
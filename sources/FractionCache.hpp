@@ -0,0 +1,81 @@
+#ifndef FRACTION_CACHE_HPP
+#define FRACTION_CACHE_HPP
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include "Fraction.hpp"
+
+enum class FractionOperation : std::uint8_t {
+    Multiply,
+    Divide,
+    FloatConversion
+};
+
+struct FractionCacheStats {
+    std::uint64_t hits = 0;
+    std::uint64_t misses = 0;
+    std::uint64_t evictions = 0;
+};
+
+/**
+ * A thread-safe memoisation cache for Fraction::operator*, Fraction::operator/ and Fraction::floatToFraction.
+ *
+ * Results are keyed on the operation and its canonical operands (reduced parts, every zero as 0/1, and the
+ * operands of a multiplication in a fixed order). The cache is split into independently locked shards; each shard
+ * is set-associative with four entries per set and evicts with the clock (second chance) policy inside a set.
+ * Operations that throw are not cached and the exception reaches the caller.
+ */
+class FractionCache {
+
+private:
+
+    static const std::size_t WAYS = 4;
+    static const std::size_t SHARDS = 16;
+
+    struct Entry {
+        std::uint64_t left = 0;
+        std::uint64_t right = 0;
+        std::uint64_t result = 0;
+        FractionOperation operation = FractionOperation::Multiply;
+        bool valid = false;
+        bool referenced = false;
+    };
+
+    struct Shard {
+        std::mutex mutex;
+        std::vector<Entry> entries;
+        std::vector<std::uint8_t> hands;
+    };
+
+    std::unique_ptr<Shard[]> shards;
+    std::size_t setMask;
+    std::atomic<std::uint64_t> hits{0};
+    std::atomic<std::uint64_t> misses{0};
+    std::atomic<std::uint64_t> evictions{0};
+
+    template<class Compute>
+    Fraction lookup(FractionOperation operation, std::uint64_t left, std::uint64_t right, Compute compute);
+
+public:
+
+    explicit FractionCache(std::size_t capacity = std::size_t{1} << 14U);
+
+    Fraction multiply(const Fraction &first, const Fraction &second);
+
+    Fraction divide(const Fraction &dividend, const Fraction &divisor);
+
+    Fraction floatToFraction(float value);
+
+    [[nodiscard]] FractionCacheStats stats() const;
+
+    [[nodiscard]] std::size_t capacity() const;
+
+    void clear();
+};
+
+#endif
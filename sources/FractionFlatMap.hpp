@@ -0,0 +1,368 @@
+#ifndef FRACTION_FLAT_MAP_HPP
+#define FRACTION_FLAT_MAP_HPP
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+#include "Fraction.hpp"
+#include "FractionHash.hpp"
+
+/**
+ * Open-addressing hash map keyed by Fraction, laid out for scans over large key sets.
+ *
+ * Keys are stored structure-of-arrays (numerators, denominators and values in separate arrays) next to one control
+ * byte per slot. A control byte holds 7 bits of the key's hash, or marks the slot empty or deleted, and probing
+ * compares 16 control bytes at once (with SSE2 when available), so most lookups touch a single cache line of control
+ * bytes and at most one key. Keys are stored in canonical form, in which every zero is 0/1, matching
+ * Fraction::operator==.
+ *
+ * Values must be default constructible; unused slots hold a default-constructed value.
+ */
+template<class V>
+class FractionFlatMap {
+
+private:
+
+    static constexpr std::size_t GROUP = 16;
+    static constexpr std::int8_t EMPTY = -128;
+    static constexpr std::int8_t DELETED = -2;
+    static constexpr std::size_t NPOS = static_cast<std::size_t>(-1);
+
+    std::vector<std::int8_t> control;
+    std::vector<int> numerators;
+    std::vector<int> denominators;
+    std::vector<V> values;
+    std::size_t mask = 0;
+    std::size_t count = 0;
+    std::size_t tombstones = 0;
+
+    struct Key {
+        int numerator;
+        int denominator;
+        std::uint64_t hash;
+    };
+
+    static Key canonicalKey(const Fraction &fraction) {
+        int numerator = fraction.getNumerator();
+        int denominator = numerator == 0 ? 1 : fraction.getDenominator();
+        return {numerator, denominator, mixFractionKey(packFractionKey(numerator, denominator))};
+    }
+
+    static std::int8_t tag(std::uint64_t hash) {
+        return static_cast<std::int8_t>(hash & 0x7FU);
+    }
+
+    [[nodiscard]] std::size_t start(std::uint64_t hash) const {
+        return static_cast<std::size_t>(hash >> 7U) & mask;
+    }
+
+    /**
+     * @return A bit mask of the control bytes in the group at position that equal value.
+     */
+    [[nodiscard]] std::uint32_t matchTag(std::size_t position, std::int8_t value) const {
+#if defined(__SSE2__)
+        __m128i group = _mm_loadu_si128(reinterpret_cast<const __m128i *>(control.data() + position));
+        return static_cast<std::uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(group, _mm_set1_epi8(value))));
+#else
+        std::uint32_t bits = 0;
+        for (std::size_t i = 0; i < GROUP; ++i) {
+            if (control[position + i] == value) bits |= 1U << i;
+        }
+        return bits;
+#endif
+    }
+
+    /**
+     * @return A bit mask of the empty or deleted control bytes in the group at position.
+     */
+    [[nodiscard]] std::uint32_t matchFree(std::size_t position) const {
+#if defined(__SSE2__)
+        __m128i group = _mm_loadu_si128(reinterpret_cast<const __m128i *>(control.data() + position));
+        return static_cast<std::uint32_t>(_mm_movemask_epi8(_mm_cmplt_epi8(group, _mm_set1_epi8(-1))));
+#else
+        std::uint32_t bits = 0;
+        for (std::size_t i = 0; i < GROUP; ++i) {
+            if (control[position + i] < -1) bits |= 1U << i;
+        }
+        return bits;
+#endif
+    }
+
+    static std::size_t lowestBit(std::uint32_t bits) {
+        return static_cast<std::size_t>(__builtin_ctz(bits));
+    }
+
+    /**
+     * Writes a control byte, mirroring the first group after the end so that groups can be loaded unaligned
+     * without wrapping.
+     */
+    void setControl(std::size_t index, std::int8_t value) {
+        control[index] = value;
+        if (index < GROUP) control[mask + 1 + index] = value;
+    }
+
+    [[nodiscard]] std::size_t findIndex(const Key &key) const {
+        std::int8_t keyTag = tag(key.hash);
+        std::size_t position = start(key.hash);
+        for (std::size_t step = GROUP;; step += GROUP) {
+            for (std::uint32_t bits = matchTag(position, keyTag); bits != 0; bits &= bits - 1) {
+                std::size_t index = (position + lowestBit(bits)) & mask;
+                if (numerators[index] == key.numerator && denominators[index] == key.denominator) return index;
+            }
+            if (matchTag(position, EMPTY) != 0) return NPOS;
+            position = (position + step) & mask;
+        }
+    }
+
+    [[nodiscard]] std::size_t findFree(std::uint64_t hash) const {
+        std::size_t position = start(hash);
+        for (std::size_t step = GROUP;; step += GROUP) {
+            std::uint32_t bits = matchFree(position);
+            if (bits != 0) return (position + lowestBit(bits)) & mask;
+            position = (position + step) & mask;
+        }
+    }
+
+    void rehash(std::size_t newCapacity) {
+        std::vector<std::int8_t> oldControl = std::move(control);
+        std::vector<int> oldNumerators = std::move(numerators);
+        std::vector<int> oldDenominators = std::move(denominators);
+        std::vector<V> oldValues = std::move(values);
+
+        control.assign(newCapacity + GROUP, EMPTY);
+        numerators.assign(newCapacity, 0);
+        denominators.assign(newCapacity, 0);
+        values = std::vector<V>(newCapacity);
+        mask = newCapacity - 1;
+        tombstones = 0;
+
+        for (std::size_t i = 0; i < oldNumerators.size(); ++i) {
+            if (oldControl[i] < 0) continue;
+            std::uint64_t hash = mixFractionKey(packFractionKey(oldNumerators[i], oldDenominators[i]));
+            std::size_t index = findFree(hash);
+            setControl(index, tag(hash));
+            numerators[index] = oldNumerators[i];
+            denominators[index] = oldDenominators[i];
+            values[index] = std::move(oldValues[i]);
+        }
+    }
+
+    /**
+     * Finds the slot of the key, claiming a free slot for it if it is absent.
+     * @return The slot index and whether the key was inserted.
+     */
+    std::pair<std::size_t, bool> findOrInsert(const Key &key) {
+        std::size_t index = findIndex(key);
+        if (index != NPOS) return {index, false};
+
+        std::size_t capacity = mask + 1;
+        if ((count + tombstones + 1) * 8 > capacity * 7) {
+            rehash(count * 2 + 2 > capacity ? capacity * 2 : capacity);
+        }
+        index = findFree(key.hash);
+        if (control[index] == DELETED) --tombstones;
+        setControl(index, tag(key.hash));
+        numerators[index] = key.numerator;
+        denominators[index] = key.denominator;
+        ++count;
+        return {index, true};
+    }
+
+public:
+
+    explicit FractionFlatMap(std::size_t capacity = GROUP) {
+        std::size_t size = GROUP;
+        while (size * 7 < capacity * 8) size <<= 1U;
+        rehash(size);
+    }
+
+    [[nodiscard]] std::size_t size() const {
+        return count;
+    }
+
+    [[nodiscard]] bool empty() const {
+        return count == 0;
+    }
+
+    [[nodiscard]] std::size_t capacity() const {
+        return mask + 1;
+    }
+
+    /**
+     * Grows the table so that at least expected keys fit without another rehash.
+     */
+    void reserve(std::size_t expected) {
+        std::size_t size = mask + 1;
+        while (size * 7 < expected * 8) size <<= 1U;
+        if (size != mask + 1) rehash(size);
+    }
+
+    void clear() {
+        std::fill(control.begin(), control.end(), EMPTY);
+        std::fill(values.begin(), values.end(), V());
+        count = 0;
+        tombstones = 0;
+    }
+
+    /**
+     * @return The value for key, default-constructing it first if the key is absent.
+     */
+    V &operator[](const Fraction &key) {
+        return values[findOrInsert(canonicalKey(key)).first];
+    }
+
+    /**
+     * Inserts key with value, or overwrites the value if the key is present.
+     * @return True if the key was inserted, false if it was already present.
+     */
+    bool insert(const Fraction &key, const V &value) {
+        std::pair<std::size_t, bool> slot = findOrInsert(canonicalKey(key));
+        values[slot.first] = value;
+        return slot.second;
+    }
+
+    V *find(const Fraction &key) {
+        std::size_t index = findIndex(canonicalKey(key));
+        return index == NPOS ? nullptr : &values[index];
+    }
+
+    const V *find(const Fraction &key) const {
+        std::size_t index = findIndex(canonicalKey(key));
+        return index == NPOS ? nullptr : &values[index];
+    }
+
+    [[nodiscard]] bool contains(const Fraction &key) const {
+        return findIndex(canonicalKey(key)) != NPOS;
+    }
+
+    /**
+     * Removes key, leaving a tombstone that later inserts reuse.
+     * @return True if the key was present.
+     */
+    bool erase(const Fraction &key) {
+        std::size_t index = findIndex(canonicalKey(key));
+        if (index == NPOS) return false;
+        setControl(index, DELETED);
+        values[index] = V();
+        --count;
+        ++tombstones;
+        return true;
+    }
+
+    /**
+     * Inserts or overwrites count key/value pairs. Keys are hashed and their first control group prefetched a block
+     * ahead of the probes, so the cache misses of a block overlap.
+     */
+    void insertBulk(const Fraction *keys, const V *newValues, std::size_t keyCount) {
+        reserve(count + keyCount);
+        Key block[GROUP];
+        for (std::size_t first = 0; first < keyCount; first += GROUP) {
+            std::size_t blockSize = std::min(GROUP, keyCount - first);
+            for (std::size_t i = 0; i < blockSize; ++i) {
+                block[i] = canonicalKey(keys[first + i]);
+                __builtin_prefetch(control.data() + start(block[i].hash));
+            }
+            for (std::size_t i = 0; i < blockSize; ++i) {
+                values[findOrInsert(block[i]).first] = newValues[first + i];
+            }
+        }
+    }
+
+    /**
+     * Looks up count keys, storing a pointer to each value (or nullptr for absent keys) in results.
+     */
+    void findBulk(const Fraction *keys, std::size_t keyCount, const V **results) const {
+        Key block[GROUP];
+        for (std::size_t first = 0; first < keyCount; first += GROUP) {
+            std::size_t blockSize = std::min(GROUP, keyCount - first);
+            for (std::size_t i = 0; i < blockSize; ++i) {
+                block[i] = canonicalKey(keys[first + i]);
+                __builtin_prefetch(control.data() + start(block[i].hash));
+            }
+            for (std::size_t i = 0; i < blockSize; ++i) {
+                std::size_t index = findIndex(block[i]);
+                results[first + i] = index == NPOS ? nullptr : &values[index];
+            }
+        }
+    }
+
+    /**
+     * Calls visit(Fraction, const V &) for every entry, in slot order.
+     */
+    template<class Visitor>
+    void forEach(Visitor visit) const {
+        for (std::size_t i = 0; i <= mask; ++i) {
+            if (control[i] >= 0) visit(Fraction::fromReduced(numerators[i], denominators[i]), values[i]);
+        }
+    }
+};
+
+/**
+ * Set of Fractions with the layout and probing of FractionFlatMap.
+ */
+class FractionFlatSet {
+
+private:
+
+    FractionFlatMap<unsigned char> map;
+
+public:
+
+    explicit FractionFlatSet(std::size_t capacity = 16) : map(capacity) {}
+
+    [[nodiscard]] std::size_t size() const {
+        return map.size();
+    }
+
+    [[nodiscard]] bool empty() const {
+        return map.empty();
+    }
+
+    void reserve(std::size_t expected) {
+        map.reserve(expected);
+    }
+
+    void clear() {
+        map.clear();
+    }
+
+    bool insert(const Fraction &key) {
+        return map.insert(key, 1);
+    }
+
+    [[nodiscard]] bool contains(const Fraction &key) const {
+        return map.contains(key);
+    }
+
+    bool erase(const Fraction &key) {
+        return map.erase(key);
+    }
+
+    void insertBulk(const Fraction *keys, std::size_t keyCount) {
+        std::vector<unsigned char> present(keyCount, 1);
+        map.insertBulk(keys, present.data(), keyCount);
+    }
+
+    /**
+     * Stores whether each of count keys is in the set in results.
+     */
+    void containsBulk(const Fraction *keys, std::size_t keyCount, bool *results) const {
+        std::vector<const unsigned char *> found(keyCount);
+        map.findBulk(keys, keyCount, found.data());
+        for (std::size_t i = 0; i < keyCount; ++i) results[i] = found[i] != nullptr;
+    }
+
+    template<class Visitor>
+    void forEach(Visitor visit) const {
+        map.forEach([&visit](const Fraction &key, unsigned char) { visit(key); });
+    }
+};
+
+#endif
@@ -0,0 +1,14 @@
+#include "FractionHash.hpp"
+
+/**
+ * Hashes a Fraction by mixing its packed numerator and denominator.
+ * Fraction::operator== compares the parts, except that every zero equals every other zero, so zeros are hashed
+ * as 0/1.
+ * @param fraction The Fraction to hash.
+ * @return A well-mixed 64-bit hash of the fraction.
+ */
+std::uint64_t hashFraction(const Fraction &fraction) {
+    int numerator = fraction.getNumerator();
+    int denominator = numerator == 0 ? 1 : fraction.getDenominator();
+    return mixFractionKey(packFractionKey(numerator, denominator));
+}
@@ -0,0 +1,43 @@
+#ifndef FRACTION_HASH_HPP
+#define FRACTION_HASH_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+
+#include "Fraction.hpp"
+
+/**
+ * Packs a numerator and a denominator into one 64-bit key, numerator in the high half.
+ * A key with a zero denominator never describes a Fraction, so the key 0 is free for use as an empty marker.
+ */
+inline std::uint64_t packFractionKey(int numerator, int denominator) {
+    return (std::uint64_t{static_cast<std::uint32_t>(numerator)} << 32U) | static_cast<std::uint32_t>(denominator);
+}
+
+/**
+ * 64-bit finaliser from SplitMix64: every input bit affects every output bit, so structured keys such as small
+ * numerator/denominator pairs spread evenly over power-of-two tables.
+ */
+inline std::uint64_t mixFractionKey(std::uint64_t key) {
+    key ^= key >> 30U;
+    key *= 0xbf58476d1ce4e5b9ULL;
+    key ^= key >> 27U;
+    key *= 0x94d049bb133111ebULL;
+    key ^= key >> 31U;
+    return key;
+}
+
+std::uint64_t hashFraction(const Fraction &fraction);
+
+/**
+ * Hash consistent with Fraction::operator==: all zeros hash alike whatever their denominator.
+ */
+template<>
+struct std::hash<Fraction> {
+    std::size_t operator()(const Fraction &fraction) const noexcept {
+        return static_cast<std::size_t>(hashFraction(fraction));
+    }
+};
+
+#endif
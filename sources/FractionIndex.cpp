@@ -0,0 +1,113 @@
+#include "FractionIndex.hpp"
+
+#include <cstdint>
+#include <utility>
+
+#include "FractionSort.hpp"
+
+/**
+ * How many levels below the current node are prefetched. Nodes are 16 bytes, so the 2^4 descendants four levels
+ * down span four cache lines starting at index 16 * node. Near the leaves that index lies past the end of the array,
+ * so the address is computed as an integer rather than by pointer arithmetic; a prefetch never faults.
+ */
+static const std::size_t PREFETCH_LEVELS = 4;
+
+/**
+ * Builds the index. The fractions are sorted by value (with radixSortFractions) and duplicates are kept.
+ * @param fractions The fractions to index, in any order.
+ */
+FractionIndex::FractionIndex(std::vector<Fraction> fractions) : sorted(std::move(fractions)) {
+    radixSortFractions(sorted);
+    nodes.resize(sorted.size() + 1);
+    ranks.resize(sorted.size() + 1);
+    build(0, 1);
+}
+
+/**
+ * Fills the Eytzinger array by an in-order walk of the implicit tree rooted at node.
+ * @param position The rank of the next sorted fraction to place.
+ * @param node The 1-based Eytzinger index of the subtree root.
+ * @return The rank of the next sorted fraction to place after this subtree.
+ */
+std::size_t FractionIndex::build(std::size_t position, std::size_t node) {
+    if (node > sorted.size()) return position;
+    position = build(position, 2 * node);
+    nodes[node] = {sorted[position].getNumerator(), sorted[position].getDenominator()};
+    ranks[node] = position;
+    return build(position + 1, 2 * node + 1);
+}
+
+/**
+ * Branchless Eytzinger search: descends right while the node is less than value (or, when Inclusive, less than or
+ * equal to it), then strips the trailing right turns to recover the answer node.
+ * @return The rank of the first fraction greater than or equal to value (greater than value when Inclusive), or
+ * size() when there is none.
+ */
+template<bool Inclusive>
+std::size_t FractionIndex::search(const Fraction &value) const {
+    std::int64_t numerator = value.getNumerator();
+    std::int64_t denominator = value.getDenominator();
+    std::size_t count = sorted.size();
+    const Node *data = nodes.data();
+    auto base = reinterpret_cast<std::uintptr_t>(data);
+
+    std::size_t node = 1;
+    while (node <= count) {
+        __builtin_prefetch(reinterpret_cast<const void *>(base + (node << PREFETCH_LEVELS) * sizeof(Node)));
+        std::int64_t left = data[node].numerator * denominator;
+        std::int64_t right = numerator * data[node].denominator;
+        bool goRight = Inclusive ? left <= right : left < right;
+        node = 2 * node + static_cast<std::size_t>(goRight);
+    }
+    node >>= static_cast<unsigned>(__builtin_ffsll(static_cast<long long>(~node)));
+    return node == 0 ? count : ranks[node];
+}
+
+std::size_t FractionIndex::size() const {
+    return sorted.size();
+}
+
+/**
+ * @param rank A rank below size().
+ * @return The fraction with the given rank in sorted order.
+ */
+Fraction FractionIndex::at(std::size_t rank) const {
+    return sorted.at(rank);
+}
+
+/**
+ * @return The rank of the first indexed fraction that is not less than value, or size() if there is none.
+ */
+std::size_t FractionIndex::lowerBound(const Fraction &value) const {
+    return search<false>(value);
+}
+
+/**
+ * @return The rank of the first indexed fraction that is greater than value, or size() if there is none.
+ */
+std::size_t FractionIndex::upperBound(const Fraction &value) const {
+    return search<true>(value);
+}
+
+/**
+ * @return The number of indexed fractions less than value.
+ */
+std::size_t FractionIndex::rank(const Fraction &value) const {
+    return search<false>(value);
+}
+
+/**
+ * @return The number of indexed fractions in the closed range [low, high].
+ */
+std::size_t FractionIndex::count(const Fraction &low, const Fraction &high) const {
+    std::size_t begin = search<false>(low);
+    std::size_t end = search<true>(high);
+    return end > begin ? end - begin : 0;
+}
+
+/**
+ * Runs lowerBound for count values, storing the ranks in results.
+ */
+void FractionIndex::lowerBoundBulk(const Fraction *values, std::size_t count, std::size_t *results) const {
+    for (std::size_t i = 0; i < count; ++i) results[i] = search<false>(values[i]);
+}
@@ -0,0 +1,55 @@
+#ifndef FRACTION_INDEX_HPP
+#define FRACTION_INDEX_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "Fraction.hpp"
+
+/**
+ * An immutable sorted set of fractions for fast rank queries, such as finding the band or tier a value falls into.
+ *
+ * The fractions are stored in Eytzinger (breadth-first binary tree) order, so a search walks one path from the root
+ * in a tight branchless loop and the nodes a few levels further down are prefetched while the current one is
+ * compared. Each node keeps its numerator and denominator widened to 64 bits next to each other, so a comparison
+ * is two multiplications on one cache line and never a gcd.
+ */
+class FractionIndex {
+
+private:
+
+    struct Node {
+        std::int64_t numerator;
+        std::int64_t denominator;
+    };
+
+    std::vector<Node> nodes;
+    std::vector<std::size_t> ranks;
+    std::vector<Fraction> sorted;
+
+    std::size_t build(std::size_t position, std::size_t node);
+
+    template<bool Inclusive>
+    [[nodiscard]] std::size_t search(const Fraction &value) const;
+
+public:
+
+    explicit FractionIndex(std::vector<Fraction> fractions);
+
+    [[nodiscard]] std::size_t size() const;
+
+    [[nodiscard]] Fraction at(std::size_t rank) const;
+
+    [[nodiscard]] std::size_t lowerBound(const Fraction &value) const;
+
+    [[nodiscard]] std::size_t upperBound(const Fraction &value) const;
+
+    [[nodiscard]] std::size_t rank(const Fraction &value) const;
+
+    [[nodiscard]] std::size_t count(const Fraction &low, const Fraction &high) const;
+
+    void lowerBoundBulk(const Fraction *values, std::size_t count, std::size_t *results) const;
+};
+
+#endif
@@ -0,0 +1,120 @@
+#include "FractionIntern.hpp"
+#include "FractionHash.hpp"
+
+#include <cmath>
+#include <stdexcept>
+
+FractionHandle::FractionHandle(std::uint32_t id) : id(id) {}
+
+std::uint32_t FractionHandle::getId() const {
+    return id;
+}
+
+bool FractionHandle::operator==(const FractionHandle &other) const {
+    return id == other.id;
+}
+
+bool FractionHandle::operator!=(const FractionHandle &other) const {
+    return id != other.id;
+}
+
+static int keyNumerator(std::uint64_t key) {
+    return static_cast<int>(static_cast<std::uint32_t>(key >> 32U));
+}
+
+static int keyDenominator(std::uint64_t key) {
+    return static_cast<int>(static_cast<std::uint32_t>(key));
+}
+
+/**
+ * Creates an empty table.
+ * @param capacity The number of slots, rounded up to a power of two. Each raw pair and each distinct reduced value
+ * occupies one slot.
+ */
+FractionInternTable::FractionInternTable(std::size_t capacity) : mask(0) {
+    std::size_t size = 2;
+    while (size < capacity) size <<= 1U;
+    if (size > UNSET) throw std::invalid_argument("Fraction intern table capacity is too large");
+    slots = std::make_unique<Slot[]>(size);
+    mask = size - 1;
+}
+
+/**
+ * Finds or inserts the key and returns the id of its reduced form.
+ * A slot is claimed with a CAS on its key; its canonical id is published afterwards. Threads that find a claimed slot
+ * whose id is not published yet compute the same id themselves, so no thread ever waits for another.
+ * @param key The packed (numerator, denominator) pair, with a non-zero denominator.
+ * @throws std::overflow_error If the table is full.
+ * @return The id of the slot holding the reduced form of the key.
+ */
+std::uint32_t FractionInternTable::internKey(std::uint64_t key) {
+    std::size_t index = mixFractionKey(key) & mask;
+    for (std::size_t probe = 0; probe <= mask; ++probe, index = (index + 1) & mask) {
+        Slot &slot = slots[index];
+        std::uint64_t current = slot.key.load(std::memory_order_acquire);
+        if (current == 0) {
+            if (slot.key.compare_exchange_strong(current, key, std::memory_order_acq_rel)) {
+                used.fetch_add(1, std::memory_order_relaxed);
+                current = key;
+            }
+        }
+        if (current != key) continue;
+
+        std::uint32_t id = slot.canonical.load(std::memory_order_acquire);
+        if (id != UNSET) return id;
+
+        Fraction reduced(keyNumerator(key), keyDenominator(key));
+        std::uint64_t canonicalKey = packFractionKey(reduced.getNumerator(), reduced.getDenominator());
+        id = canonicalKey == key ? static_cast<std::uint32_t>(index) : internKey(canonicalKey);
+        slot.canonical.store(id, std::memory_order_release);
+        return id;
+    }
+    throw std::overflow_error("Fraction intern table is full");
+}
+
+/**
+ * Interns numerator/denominator.
+ * @throws std::invalid_argument If the denominator is 0.
+ * @throws std::overflow_error If the table is full.
+ * @return The handle of the reduced fraction.
+ */
+FractionHandle FractionInternTable::intern(int numerator, int denominator) {
+    if (denominator == 0) throw std::invalid_argument("0");
+    return FractionHandle(internKey(packFractionKey(numerator, denominator)));
+}
+
+FractionHandle FractionInternTable::intern(const Fraction &fraction) {
+    return intern(fraction.getNumerator(), fraction.getDenominator());
+}
+
+/**
+ * Interns a float with the 1/1000 precision of Fraction::floatToFraction, keyed by the unreduced thousandths so that
+ * repeated floats skip the reduction.
+ * @throws std::overflow_error If the table is full.
+ * @return The handle of Fraction::floatToFraction(value).
+ */
+FractionHandle FractionInternTable::internFloat(float value) {
+    int sign = value < 0 ? -1 : 1;
+    int thousandths = static_cast<int>(std::abs(value) * 1000.0f);
+    return FractionHandle(internKey(packFractionKey(thousandths * sign, 1000)));
+}
+
+/**
+ * @param handle A handle returned by this table.
+ * @return The reduced Fraction the handle stands for.
+ */
+Fraction FractionInternTable::value(FractionHandle handle) const {
+    std::uint64_t key = slots[handle.getId() & mask].key.load(std::memory_order_acquire);
+    return Fraction::fromReduced(keyNumerator(key), keyDenominator(key));
+}
+
+/**
+ * @return The number of occupied slots (raw pairs and reduced values together).
+ */
+std::size_t FractionInternTable::size() const {
+    return used.load(std::memory_order_relaxed);
+}
+
+std::size_t FractionInternTable::capacity() const {
+    return mask + 1;
+}
@@ -0,0 +1,71 @@
+#ifndef FRACTION_INTERN_HPP
+#define FRACTION_INTERN_HPP
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+#include "Fraction.hpp"
+
+/**
+ * A handle to an interned Fraction. Handles from the same FractionInternTable are equal exactly when the fractions
+ * they stand for are equal, so comparing them is a single integer comparison.
+ */
+class FractionHandle {
+
+private:
+
+    std::uint32_t id;
+
+public:
+
+    explicit FractionHandle(std::uint32_t id);
+
+    [[nodiscard]] std::uint32_t getId() const;
+
+    bool operator==(const FractionHandle &other) const;
+
+    bool operator!=(const FractionHandle &other) const;
+};
+
+/**
+ * A fixed-capacity, lock-free open-addressing table mapping raw (numerator, denominator) pairs to the handle of their
+ * reduced form. The first intern of a pair pays for the normalisation; every later intern of the same pair is a table
+ * hit with no gcd. Entries are never removed.
+ */
+class FractionInternTable {
+
+private:
+
+    struct Slot {
+        std::atomic<std::uint64_t> key{0};
+        std::atomic<std::uint32_t> canonical{UNSET};
+    };
+
+    static const std::uint32_t UNSET = 0xFFFFFFFFU;
+
+    std::unique_ptr<Slot[]> slots;
+    std::size_t mask;
+    std::atomic<std::size_t> used{0};
+
+    std::uint32_t internKey(std::uint64_t key);
+
+public:
+
+    explicit FractionInternTable(std::size_t capacity = std::size_t{1} << 16U);
+
+    FractionHandle intern(int numerator, int denominator);
+
+    FractionHandle intern(const Fraction &fraction);
+
+    FractionHandle internFloat(float value);
+
+    [[nodiscard]] Fraction value(FractionHandle handle) const;
+
+    [[nodiscard]] std::size_t size() const;
+
+    [[nodiscard]] std::size_t capacity() const;
+};
+
+#endif
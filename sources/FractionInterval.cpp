@@ -0,0 +1,240 @@
+#include "FractionInterval.hpp"
+
+#include <algorithm>
+#include <cstdint>
+#include <sstream>
+#include <stdexcept>
+#include <utility>
+
+#include "ContinuedFraction.hpp"
+
+/**
+ * An exact value numerator / denominator with a positive denominator, not necessarily reduced. The sum, difference,
+ * product or quotient of two Fractions always fits: both parts stay below 2^63 in magnitude.
+ */
+struct Endpoint {
+    std::int64_t numerator;
+    std::int64_t denominator;
+};
+
+static Endpoint endpoint(const Fraction &fraction) {
+    return {fraction.getNumerator(), fraction.getDenominator()};
+}
+
+static Endpoint add(const Endpoint &left, const Endpoint &right) {
+    return {left.numerator * right.denominator + right.numerator * left.denominator,
+            left.denominator * right.denominator};
+}
+
+static Endpoint subtract(const Endpoint &left, const Endpoint &right) {
+    return {left.numerator * right.denominator - right.numerator * left.denominator,
+            left.denominator * right.denominator};
+}
+
+static Endpoint multiply(const Endpoint &left, const Endpoint &right) {
+    return {left.numerator * right.numerator, left.denominator * right.denominator};
+}
+
+static Endpoint divide(const Endpoint &left, const Endpoint &right) {
+    Endpoint result{left.numerator * right.denominator, left.denominator * right.numerator};
+    if (result.denominator < 0) result = {-result.numerator, -result.denominator};
+    return result;
+}
+
+/**
+ * Compares two values exactly, by cross-multiplying in 128 bits.
+ * @return A negative number, zero or a positive number as left is below, equal to or above right.
+ */
+static int compare(const Endpoint &left, const Endpoint &right) {
+    __int128 leftScaled = static_cast<__int128>(left.numerator) * right.denominator;
+    __int128 rightScaled = static_cast<__int128>(right.numerator) * left.denominator;
+    return (leftScaled > rightScaled) - (leftScaled < rightScaled);
+}
+
+/**
+ * @return The smallest and the largest of the candidates.
+ */
+static std::pair<Endpoint, Endpoint> extremes(const Endpoint (&candidates)[4]) {
+    std::pair<Endpoint, Endpoint> result{candidates[0], candidates[0]};
+    for (const Endpoint &candidate: candidates) {
+        if (compare(candidate, result.first) < 0) result.first = candidate;
+        if (compare(candidate, result.second) > 0) result.second = candidate;
+    }
+    return result;
+}
+
+/**
+ * Rounds an exact value outward to a Fraction whose denominator does not exceed bound.
+ * @param upward Whether to round up, to the smallest such Fraction at least the value, rather than down, to the
+ * largest one at most the value.
+ * @throws std::overflow_error If the rounded value does not fit in a Fraction.
+ */
+static Fraction roundOutward(const Endpoint &value, int bound, bool upward) {
+    bool negative = value.numerator < 0;
+    auto n = static_cast<std::uint64_t>(negative ? -value.numerator : value.numerator);
+    auto d = static_cast<std::uint64_t>(value.denominator);
+    auto limit = static_cast<std::uint64_t>(std::numeric_limits<int>::max());
+    if (n / d > limit) throw std::overflow_error("Integer overflow");
+    ContinuedFractionBracket<std::uint64_t> bracket = bracketContinuedFraction(n, d, static_cast<std::uint64_t>(bound));
+    // Rounding -x up is rounding x down, negated.
+    const std::pair<std::uint64_t, std::uint64_t> &result = upward != negative ? bracket.above() : bracket.below();
+    if (result.first > limit) throw std::overflow_error("Integer overflow");
+    int numerator = static_cast<int>(result.first);
+    return Fraction::fromReduced(negative ? -numerator : numerator, static_cast<int>(result.second));
+}
+
+/**
+ * Builds an interval from endpoints that are already within the bound and in order.
+ */
+FractionInterval FractionInterval::fromRounded(const Fraction &lower, const Fraction &upper, int maxDenominator) {
+    FractionInterval result;
+    result.lower = lower;
+    result.upper = upper;
+    result.maxDenominator = maxDenominator;
+    return result;
+}
+
+FractionInterval::FractionInterval() = default;
+
+/**
+ * Constructs the narrowest interval with endpoint denominators up to maxDenominator that contains the value; with the
+ * default bound, the point interval [value, value].
+ * @throws std::invalid_argument If maxDenominator is not positive.
+ */
+FractionInterval::FractionInterval(const Fraction &value, int maxDenominator)
+        : FractionInterval(value, value, maxDenominator) {}
+
+/**
+ * Constructs the narrowest interval with endpoint denominators up to maxDenominator that contains [lower, upper].
+ * @throws std::invalid_argument If maxDenominator is not positive or lower exceeds upper.
+ */
+FractionInterval::FractionInterval(const Fraction &lower, const Fraction &upper, int maxDenominator)
+        : maxDenominator(maxDenominator) {
+    if (maxDenominator <= 0) throw std::invalid_argument("Denominator bound must be positive");
+    if (compare(endpoint(lower), endpoint(upper)) > 0) {
+        throw std::invalid_argument("Lower endpoint exceeds upper endpoint");
+    }
+    this->lower = roundOutward(endpoint(lower), maxDenominator, false);
+    this->upper = roundOutward(endpoint(upper), maxDenominator, true);
+}
+
+const Fraction &FractionInterval::getLower() const {
+    return lower;
+}
+
+const Fraction &FractionInterval::getUpper() const {
+    return upper;
+}
+
+int FractionInterval::getMaxDenominator() const {
+    return maxDenominator;
+}
+
+BigFraction FractionInterval::width() const {
+    return BigFraction(upper) - BigFraction(lower);
+}
+
+bool FractionInterval::contains(const Fraction &value) const {
+    return compare(endpoint(lower), endpoint(value)) <= 0 && compare(endpoint(value), endpoint(upper)) <= 0;
+}
+
+bool FractionInterval::contains(const FractionInterval &other) const {
+    return compare(endpoint(lower), endpoint(other.lower)) <= 0 && compare(endpoint(other.upper), endpoint(upper)) <= 0;
+}
+
+/**
+ * @return The endpoints in brackets, such as "[1/3, 1/2]".
+ */
+std::string FractionInterval::toString() const {
+    std::ostringstream stream;
+    stream << *this;
+    return stream.str();
+}
+
+std::ostream &operator<<(std::ostream &outstream, const FractionInterval &interval) {
+    return outstream << '[' << interval.lower << ", " << interval.upper << ']';
+}
+
+/**
+ * Negation is exact, so the endpoints only swap.
+ */
+FractionInterval FractionInterval::operator-() const {
+    return fromRounded(Fraction::fromReduced(-upper.getNumerator(), upper.getDenominator()),
+                       Fraction::fromReduced(-lower.getNumerator(), lower.getDenominator()), maxDenominator);
+}
+
+FractionInterval operator+(const FractionInterval &left, const FractionInterval &right) {
+    int bound = std::min(left.maxDenominator, right.maxDenominator);
+    return FractionInterval::fromRounded(
+            roundOutward(add(endpoint(left.lower), endpoint(right.lower)), bound, false),
+            roundOutward(add(endpoint(left.upper), endpoint(right.upper)), bound, true), bound);
+}
+
+FractionInterval operator-(const FractionInterval &left, const FractionInterval &right) {
+    int bound = std::min(left.maxDenominator, right.maxDenominator);
+    return FractionInterval::fromRounded(
+            roundOutward(subtract(endpoint(left.lower), endpoint(right.upper)), bound, false),
+            roundOutward(subtract(endpoint(left.upper), endpoint(right.lower)), bound, true), bound);
+}
+
+/**
+ * The exact product ranges over the products of the endpoints; its extremes are rounded outward.
+ */
+FractionInterval operator*(const FractionInterval &left, const FractionInterval &right) {
+    int bound = std::min(left.maxDenominator, right.maxDenominator);
+    Endpoint leftLower = endpoint(left.lower);
+    Endpoint leftUpper = endpoint(left.upper);
+    Endpoint rightLower = endpoint(right.lower);
+    Endpoint rightUpper = endpoint(right.upper);
+    std::pair<Endpoint, Endpoint> range = extremes({multiply(leftLower, rightLower), multiply(leftLower, rightUpper),
+                                                    multiply(leftUpper, rightLower), multiply(leftUpper, rightUpper)});
+    return FractionInterval::fromRounded(roundOutward(range.first, bound, false),
+                                         roundOutward(range.second, bound, true), bound);
+}
+
+/**
+ * The exact quotient ranges over the quotients of the endpoints; its extremes are rounded outward.
+ * @throws std::runtime_error If the divisor contains 0.
+ */
+FractionInterval operator/(const FractionInterval &left, const FractionInterval &right) {
+    if (right.lower.getNumerator() <= 0 && right.upper.getNumerator() >= 0) {
+        throw std::runtime_error("Division by 0 is not defined.");
+    }
+    int bound = std::min(left.maxDenominator, right.maxDenominator);
+    Endpoint leftLower = endpoint(left.lower);
+    Endpoint leftUpper = endpoint(left.upper);
+    Endpoint rightLower = endpoint(right.lower);
+    Endpoint rightUpper = endpoint(right.upper);
+    std::pair<Endpoint, Endpoint> range = extremes({divide(leftLower, rightLower), divide(leftLower, rightUpper),
+                                                    divide(leftUpper, rightLower), divide(leftUpper, rightUpper)});
+    return FractionInterval::fromRounded(roundOutward(range.first, bound, false),
+                                         roundOutward(range.second, bound, true), bound);
+}
+
+FractionInterval &FractionInterval::operator+=(const FractionInterval &other) {
+    return *this = *this + other;
+}
+
+FractionInterval &FractionInterval::operator-=(const FractionInterval &other) {
+    return *this = *this - other;
+}
+
+FractionInterval &FractionInterval::operator*=(const FractionInterval &other) {
+    return *this = *this * other;
+}
+
+FractionInterval &FractionInterval::operator/=(const FractionInterval &other) {
+    return *this = *this / other;
+}
+
+/**
+ * Intervals are equal when they have the same endpoints, whatever their bounds.
+ */
+bool operator==(const FractionInterval &left, const FractionInterval &right) {
+    return compare(endpoint(left.lower), endpoint(right.lower)) == 0 &&
+           compare(endpoint(left.upper), endpoint(right.upper)) == 0;
+}
+
+bool operator!=(const FractionInterval &left, const FractionInterval &right) {
+    return !(left == right);
+}
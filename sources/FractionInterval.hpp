@@ -0,0 +1,81 @@
+#ifndef FRACTION_FRACTION_INTERVAL_HPP
+#define FRACTION_FRACTION_INTERVAL_HPP
+
+#include <iostream>
+#include <limits>
+#include <string>
+
+#include "BigFraction.hpp"
+#include "Fraction.hpp"
+
+/**
+ * A closed interval [lower, upper] of rationals whose endpoints are Fractions with bounded denominators, for certified
+ * bounds that stay cheap to compute.
+ *
+ * Every operation computes its exact endpoints in 64-bit integers and rounds them outward to the nearest Fractions
+ * whose denominators do not exceed the bound, so the result always contains every value the operation can produce from
+ * values in its operands. The rounding walks the continued fraction of each exact endpoint, as Fraction::approximate
+ * does, taking the convergent or semiconvergent on the outer side; no gcd is computed. A binary operation uses the
+ * smaller bound of its operands, and a Fraction converts to an exact point interval whose bound never coarsens
+ * another's. Operations throw std::overflow_error only when an endpoint leaves the range of a Fraction.
+ */
+class FractionInterval {
+
+private:
+
+    Fraction lower;
+    Fraction upper;
+    int maxDenominator = UNBOUNDED;
+
+    static FractionInterval fromRounded(const Fraction &lower, const Fraction &upper, int maxDenominator);
+
+public:
+
+    static constexpr int UNBOUNDED = std::numeric_limits<int>::max();
+
+    FractionInterval();
+
+    FractionInterval(const Fraction &value, int maxDenominator = UNBOUNDED);
+
+    FractionInterval(const Fraction &lower, const Fraction &upper, int maxDenominator = UNBOUNDED);
+
+    [[nodiscard]] const Fraction &getLower() const;
+
+    [[nodiscard]] const Fraction &getUpper() const;
+
+    [[nodiscard]] int getMaxDenominator() const;
+
+    [[nodiscard]] BigFraction width() const;
+
+    [[nodiscard]] bool contains(const Fraction &value) const;
+
+    [[nodiscard]] bool contains(const FractionInterval &other) const;
+
+    [[nodiscard]] std::string toString() const;
+
+    friend std::ostream &operator<<(std::ostream &outstream, const FractionInterval &interval);
+
+    FractionInterval operator-() const;
+
+    friend FractionInterval operator+(const FractionInterval &left, const FractionInterval &right);
+
+    friend FractionInterval operator-(const FractionInterval &left, const FractionInterval &right);
+
+    friend FractionInterval operator*(const FractionInterval &left, const FractionInterval &right);
+
+    friend FractionInterval operator/(const FractionInterval &left, const FractionInterval &right);
+
+    FractionInterval &operator+=(const FractionInterval &other);
+
+    FractionInterval &operator-=(const FractionInterval &other);
+
+    FractionInterval &operator*=(const FractionInterval &other);
+
+    FractionInterval &operator/=(const FractionInterval &other);
+
+    friend bool operator==(const FractionInterval &left, const FractionInterval &right);
+
+    friend bool operator!=(const FractionInterval &left, const FractionInterval &right);
+};
+
+#endif
@@ -0,0 +1,815 @@
+#include "FractionMatrix.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <cstdint>
+#include <exception>
+#include <limits>
+#include <mutex>
+#include <numeric>
+#include <stdexcept>
+#include <thread>
+#include <utility>
+
+#include "WideArithmetic.hpp"
+
+/**
+ * The output tile of a product: TILE_ROWS x TILE_COLUMNS 128-bit sums, filled TILE_DEPTH terms at a time. A depth
+ * slice of one scaled row (2 KiB) stays in L1 while it meets the slices of the tile's columns (64 KiB) from L2.
+ */
+static const std::size_t TILE_ROWS = 32;
+static const std::size_t TILE_COLUMNS = 32;
+static const std::size_t TILE_DEPTH = 256;
+
+/**
+ * Below this many multiply-adds a product is computed on the calling thread alone.
+ */
+static const std::size_t PARALLEL_GRAIN = 1U << 18U;
+
+FractionMatrix::FractionMatrix() = default;
+
+/**
+ * Constructs a rows x columns matrix of zeros.
+ */
+FractionMatrix::FractionMatrix(std::size_t rows, std::size_t columns)
+        : rowCount(rows), columnCount(columns), entries(rows * columns) {}
+
+/**
+ * Constructs a matrix from a list of rows, such as {{1, 2}, {3, 4}}.
+ * @throws std::invalid_argument If the rows differ in length.
+ */
+FractionMatrix::FractionMatrix(std::initializer_list<std::initializer_list<Fraction>> rows)
+        : rowCount(rows.size()), columnCount(rows.size() == 0 ? 0 : rows.begin()->size()) {
+    entries.reserve(rowCount * columnCount);
+    for (const std::initializer_list<Fraction> &row: rows) {
+        if (row.size() != columnCount) throw std::invalid_argument("Rows must have the same length");
+        entries.insert(entries.end(), row.begin(), row.end());
+    }
+}
+
+FractionMatrix FractionMatrix::identity(std::size_t size) {
+    FractionMatrix result(size, size);
+    for (std::size_t i = 0; i < size; ++i) result(i, i) = Fraction(1, 1);
+    return result;
+}
+
+std::size_t FractionMatrix::rows() const {
+    return rowCount;
+}
+
+std::size_t FractionMatrix::columns() const {
+    return columnCount;
+}
+
+bool FractionMatrix::isSquare() const {
+    return rowCount == columnCount;
+}
+
+Fraction &FractionMatrix::operator()(std::size_t row, std::size_t column) {
+    return entries[row * columnCount + column];
+}
+
+const Fraction &FractionMatrix::operator()(std::size_t row, std::size_t column) const {
+    return entries[row * columnCount + column];
+}
+
+Fraction *FractionMatrix::data() {
+    return entries.data();
+}
+
+const Fraction *FractionMatrix::data() const {
+    return entries.data();
+}
+
+/**
+ * Scales every row of the matrix by the least common multiple of its denominators, and of the denominator of rhs[row]
+ * when rhs is given, so that the scaled rows are integers.
+ * @param extraColumns Zero columns appended to each row for the caller to fill.
+ * @param scales Receives the factor each row was scaled by.
+ * @return The scaled matrix in row-major order, with columns() + extraColumns columns.
+ */
+static std::vector<BigInt> scaleRows(const FractionMatrix &matrix, const std::vector<Fraction> *rhs,
+                                     std::size_t extraColumns, std::vector<BigInt> &scales) {
+    std::size_t width = matrix.columns() + extraColumns;
+    std::vector<BigInt> scaled(matrix.rows() * width);
+    scales.assign(matrix.rows(), BigInt(1));
+    for (std::size_t row = 0; row < matrix.rows(); ++row) {
+        BigInt &scale = scales[row];
+        for (std::size_t column = 0; column < matrix.columns(); ++column) {
+            BigInt denominator = matrix(row, column).getDenominator();
+            scale = scale / BigInt::gcd(scale, denominator) * denominator;
+        }
+        if (rhs != nullptr) {
+            BigInt denominator = (*rhs)[row].getDenominator();
+            scale = scale / BigInt::gcd(scale, denominator) * denominator;
+        }
+        for (std::size_t column = 0; column < matrix.columns(); ++column) {
+            const Fraction &entry = matrix(row, column);
+            scaled[row * width + column] = BigInt(entry.getNumerator()) * (scale / BigInt(entry.getDenominator()));
+        }
+    }
+    return scaled;
+}
+
+/**
+ * Scales the system A x = rhs free of denominators, row by row.
+ * @param scales Receives the factor each row was scaled by.
+ * @return The scaled augmented matrix [A | rhs] in row-major order, with columns() + 1 columns.
+ */
+static std::vector<BigInt> scaleSystem(const FractionMatrix &matrix, const std::vector<Fraction> &rhs,
+                                       std::vector<BigInt> &scales) {
+    std::size_t columns = matrix.columns();
+    std::vector<BigInt> scaled = scaleRows(matrix, &rhs, 1, scales);
+    for (std::size_t row = 0; row < matrix.rows(); ++row) {
+        scaled[row * (columns + 1) + columns] =
+                BigInt(rhs[row].getNumerator()) * (scales[row] / BigInt(rhs[row].getDenominator()));
+    }
+    return scaled;
+}
+
+/**
+ * Bareiss' fraction-free elimination, in place, on a rows x width integer matrix. After each pivot step every entry
+ * is a minor of the original matrix, so the division by the previous pivot is exact and entries grow only as fast as
+ * the minors do. Pivots are chosen in the first pivotColumns columns; a column without one is skipped.
+ * @param reduceAbove Whether to clear the pivot columns above the pivots as well (the Gauss-Jordan form), which leaves
+ * a nonsingular matrix diagonal with the determinant of the row-permuted matrix in every diagonal entry.
+ * @param lastPivot Receives the last pivot, which is the determinant of the row-permuted matrix when it is square and
+ * nonsingular.
+ * @param swapped Receives whether an odd number of row swaps was made.
+ * @return The number of pivots, the rank of the first pivotColumns columns.
+ */
+static std::size_t eliminate(std::vector<BigInt> &a, std::size_t rows, std::size_t width, std::size_t pivotColumns,
+                             bool reduceAbove, BigInt &lastPivot, bool &swapped) {
+    BigInt previous = 1;
+    std::size_t rank = 0;
+    swapped = false;
+    for (std::size_t column = 0; column < pivotColumns && rank < rows; ++column) {
+        std::size_t pivotRow = rank;
+        while (pivotRow < rows && a[pivotRow * width + column].isZero()) ++pivotRow;
+        if (pivotRow == rows) continue;
+        if (pivotRow != rank) {
+            std::swap_ranges(a.begin() + static_cast<std::ptrdiff_t>(pivotRow * width),
+                             a.begin() + static_cast<std::ptrdiff_t>((pivotRow + 1) * width),
+                             a.begin() + static_cast<std::ptrdiff_t>(rank * width));
+            swapped = !swapped;
+        }
+        BigInt pivot = a[rank * width + column];
+        const BigInt *pivotRowEntries = &a[rank * width];
+        for (std::size_t row = reduceAbove ? 0 : rank + 1; row < rows; ++row) {
+            if (row == rank) continue;
+            BigInt *entries = &a[row * width];
+            BigInt factor = entries[column];
+            for (std::size_t j = reduceAbove ? 0 : column + 1; j < width; ++j) {
+                if (j == column) continue;
+                if (pivotRowEntries[j].isZero()) {
+                    if (!entries[j].isZero()) entries[j] = pivot * entries[j] / previous;
+                } else {
+                    entries[j] = (pivot * entries[j] - factor * pivotRowEntries[j]) / previous;
+                }
+            }
+            entries[column] = 0;
+        }
+        previous = std::move(pivot);
+        ++rank;
+    }
+    lastPivot = std::move(previous);
+    return rank;
+}
+
+/**
+ * @throws std::invalid_argument If the matrix is not square.
+ * @return The exact determinant; 1 for the empty matrix.
+ */
+BigFraction FractionMatrix::determinant() const {
+    if (!isSquare()) throw std::invalid_argument("Matrix is not square");
+    std::vector<BigInt> scales;
+    std::vector<BigInt> scaled = scaleRows(*this, nullptr, 0, scales);
+    BigInt pivot;
+    bool swapped = false;
+    if (eliminate(scaled, rowCount, columnCount, columnCount, false, pivot, swapped) < rowCount) return {};
+    BigInt scale = 1;
+    for (const BigInt &rowScale: scales) scale *= rowScale;
+    return {swapped ? -pivot : pivot, scale};
+}
+
+std::size_t FractionMatrix::rank() const {
+    std::vector<BigInt> scales;
+    std::vector<BigInt> scaled = scaleRows(*this, nullptr, 0, scales);
+    BigInt pivot;
+    bool swapped = false;
+    return eliminate(scaled, rowCount, columnCount, columnCount, false, pivot, swapped);
+}
+
+/**
+ * Solves A x = rhs exactly by fraction-free Gauss-Jordan elimination on the augmented, denominator-free system:
+ * it leaves d x_i in the last column of row i, with d the common diagonal entry, and x_i is that one quotient.
+ * @throws std::invalid_argument If the matrix is not square or rhs does not have one entry per row.
+ * @throws std::runtime_error If the matrix is singular.
+ * @return The unique solution x.
+ */
+std::vector<BigFraction> FractionMatrix::solve(const std::vector<Fraction> &rhs) const {
+    if (!isSquare()) throw std::invalid_argument("Matrix is not square");
+    if (rhs.size() != rowCount) throw std::invalid_argument("Matrix dimensions do not match");
+    std::size_t width = columnCount + 1;
+    std::vector<BigInt> scales;
+    std::vector<BigInt> scaled = scaleSystem(*this, rhs, scales);
+    BigInt pivot;
+    bool swapped = false;
+    if (eliminate(scaled, rowCount, width, columnCount, true, pivot, swapped) < rowCount) {
+        throw std::runtime_error("Matrix is singular");
+    }
+    std::vector<BigFraction> solution;
+    solution.reserve(rowCount);
+    for (std::size_t row = 0; row < rowCount; ++row) {
+        solution.emplace_back(scaled[row * width + columnCount], scaled[row * width + row]);
+    }
+    return solution;
+}
+
+/**
+ * Inverts the matrix by fraction-free Gauss-Jordan elimination of [S A | I], where S scales each row free of
+ * denominators: it leaves d (S A)^-1 on the right, and A^-1 = (S A)^-1 S.
+ * @throws std::invalid_argument If the matrix is not square.
+ * @throws std::runtime_error If the matrix is singular.
+ * @throws std::overflow_error If an entry of the inverse does not fit in a Fraction.
+ * @return The inverse.
+ */
+FractionMatrix FractionMatrix::inverse() const {
+    if (!isSquare()) throw std::invalid_argument("Matrix is not square");
+    std::size_t width = 2 * columnCount;
+    std::vector<BigInt> scales;
+    std::vector<BigInt> scaled = scaleRows(*this, nullptr, columnCount, scales);
+    for (std::size_t row = 0; row < rowCount; ++row) scaled[row * width + columnCount + row] = 1;
+    BigInt pivot;
+    bool swapped = false;
+    if (eliminate(scaled, rowCount, width, columnCount, true, pivot, swapped) < rowCount) {
+        throw std::runtime_error("Matrix is singular");
+    }
+    FractionMatrix result(rowCount, columnCount);
+    for (std::size_t row = 0; row < rowCount; ++row) {
+        const BigInt &diagonal = scaled[row * width + row];
+        for (std::size_t column = 0; column < columnCount; ++column) {
+            BigFraction entry(scaled[row * width + columnCount + column] * scales[column], diagonal);
+            result(row, column) = entry.toFraction();
+        }
+    }
+    return result;
+}
+
+/**
+ * @return threads, or std::thread::hardware_concurrency() when it is 0.
+ */
+static std::size_t workerCount(unsigned threads) {
+    return threads == 0 ? std::max(1U, std::thread::hardware_concurrency()) : threads;
+}
+
+/**
+ * Runs task(index) for every index below count on up to workers threads, the caller included, handing the indices
+ * out one at a time. After a task throws no further indices are handed out, and the first exception is rethrown.
+ */
+template<class Task>
+static void parallelFor(std::size_t count, std::size_t workers, Task task) {
+    std::atomic<std::size_t> next = 0;
+    std::atomic<bool> stop = false;
+    std::exception_ptr failure;
+    std::mutex failureLock;
+    auto work = [&]() {
+        try {
+            for (std::size_t index = next++; index < count && !stop; index = next++) task(index);
+        } catch (...) {
+            std::lock_guard<std::mutex> guard(failureLock);
+            if (!failure) failure = std::current_exception();
+            stop = true;
+        }
+    };
+    std::vector<std::thread> pool;
+    for (std::size_t worker = 1; worker < std::min(workers, count); ++worker) pool.emplace_back(work);
+    work();
+    for (std::thread &thread: pool) thread.join();
+    if (failure) std::rethrow_exception(failure);
+}
+
+/**
+ * The rows of a left factor or the columns of a right factor, each scaled by the lcm of its denominators into
+ * int64_t integers and stored contiguously, depth entries per line.
+ */
+struct ScaledLines {
+    std::vector<std::int64_t> values;
+    std::vector<std::int64_t> scales;
+    std::vector<unsigned> bits;
+};
+
+/**
+ * Scales lines of entries, where entry k of line i is entries[i * lineStride + k * entryStride].
+ * A line whose lcm or scaled entries overflow int64_t gets scale 0, and its products are computed with BigInts.
+ * bits receives the bit width of each line's largest scaled magnitude.
+ */
+static ScaledLines scaleLines(const Fraction *entries, std::size_t lines, std::size_t depth, std::size_t lineStride,
+                              std::size_t entryStride) {
+    ScaledLines scaled{std::vector<std::int64_t>(lines * depth), std::vector<std::int64_t>(lines, 1),
+                       std::vector<unsigned>(lines, 0)};
+    for (std::size_t line = 0; line < lines; ++line) {
+        const Fraction *first = entries + line * lineStride;
+        std::int64_t *values = &scaled.values[line * depth];
+        std::int64_t &scale = scaled.scales[line];
+        bool fits = true;
+        for (std::size_t k = 0; k < depth && fits; ++k) {
+            std::int64_t denominator = first[k * entryStride].getDenominator();
+            fits = !__builtin_mul_overflow(scale / std::gcd(scale, denominator), denominator, &scale);
+        }
+        std::uint64_t largest = 0;
+        for (std::size_t k = 0; k < depth && fits; ++k) {
+            const Fraction &entry = first[k * entryStride];
+            fits = !__builtin_mul_overflow(std::int64_t{entry.getNumerator()}, scale / entry.getDenominator(),
+                                           &values[k]);
+            auto magnitude = static_cast<std::uint64_t>(values[k]);
+            largest = std::max(largest, values[k] < 0 ? 0 - magnitude : magnitude);
+        }
+        if (!fits) {
+            scale = 0;
+            std::fill(values, values + depth, 0);
+        }
+        scaled.bits[line] = static_cast<unsigned>(std::bit_width(largest));
+    }
+    return scaled;
+}
+
+/**
+ * A dot product whose every partial sum is known to fit in an int64_t, in a loop the compiler can vectorize.
+ */
+static std::int64_t narrowDot(const std::int64_t *left, const std::int64_t *right, std::size_t count) {
+    std::int64_t sum = 0;
+    for (std::size_t k = 0; k < count; ++k) sum += left[k] * right[k];
+    return sum;
+}
+
+/**
+ * A dot product in 128-bit arithmetic, checked for overflow.
+ * @return false if a partial sum overflows.
+ */
+static bool wideDot(const std::int64_t *left, const std::int64_t *right, std::size_t count, __int128 &sum) {
+    sum = 0;
+    for (std::size_t k = 0; k < count; ++k) {
+        if (__builtin_add_overflow(sum, static_cast<__int128>(left[k]) * right[k], &sum)) return false;
+    }
+    return true;
+}
+
+/**
+ * One entry of a product that does not fit the 128-bit path, as a BigInt dot product over the common denominator.
+ * @throws std::overflow_error If the entry does not fit in a Fraction.
+ */
+static Fraction bigDot(const FractionMatrix &left, const FractionMatrix &right, std::size_t row, std::size_t column) {
+    std::size_t depth = left.columns();
+    BigInt leftScale = 1;
+    BigInt rightScale = 1;
+    for (std::size_t k = 0; k < depth; ++k) {
+        BigInt leftDenominator = left(row, k).getDenominator();
+        BigInt rightDenominator = right(k, column).getDenominator();
+        leftScale = leftScale / BigInt::gcd(leftScale, leftDenominator) * leftDenominator;
+        rightScale = rightScale / BigInt::gcd(rightScale, rightDenominator) * rightDenominator;
+    }
+    BigInt sum = 0;
+    for (std::size_t k = 0; k < depth; ++k) {
+        const Fraction &a = left(row, k);
+        const Fraction &b = right(k, column);
+        sum += BigInt(a.getNumerator()) * (leftScale / BigInt(a.getDenominator())) *
+               (BigInt(b.getNumerator()) * (rightScale / BigInt(b.getDenominator())));
+    }
+    return BigFraction(sum, leftScale * rightScale).toFraction();
+}
+
+/**
+ * Reduces numerator / denominator, with denominator > 0, to a Fraction.
+ * @throws std::overflow_error If the reduced parts do not fit in an int.
+ */
+static Fraction reduceWide(__int128 numerator, __int128 denominator) {
+    reduce128(numerator, denominator);
+    if (numerator < std::numeric_limits<int>::min() || numerator > std::numeric_limits<int>::max() ||
+        denominator > std::numeric_limits<int>::max()) {
+        throw std::overflow_error("Integer overflow");
+    }
+    return Fraction::fromReduced(static_cast<int>(numerator), static_cast<int>(denominator));
+}
+
+/**
+ * Multiplies exactly. Each row of left and column of right is scaled to integers once; each output tile then
+ * accumulates integer dot products over depth slices, in int64_t when the operands' bit widths guarantee no overflow
+ * and in checked 128-bit arithmetic otherwise, and divides by the two scales with a single reduction per entry.
+ * Entries that overflow 128 bits are recomputed with BigInts. Tiles are handed out to the threads dynamically.
+ * @param threads The number of threads to use; 0 uses std::thread::hardware_concurrency().
+ * @throws std::invalid_argument If left.columns() != right.rows().
+ * @throws std::overflow_error If an entry of the product does not fit in a Fraction.
+ */
+FractionMatrix FractionMatrix::multiply(const FractionMatrix &left, const FractionMatrix &right, unsigned threads) {
+    if (left.columnCount != right.rowCount) throw std::invalid_argument("Matrix dimensions do not match");
+    std::size_t rows = left.rowCount;
+    std::size_t columns = right.columnCount;
+    std::size_t depth = left.columnCount;
+    FractionMatrix result(rows, columns);
+    if (rows == 0 || columns == 0) return result;
+    ScaledLines scaledRows = scaleLines(left.data(), rows, depth, depth, 1);
+    ScaledLines scaledColumns = scaleLines(right.data(), columns, depth, 1, columns);
+
+    auto computeTile = [&](std::size_t rowBegin, std::size_t columnBegin) {
+        std::size_t rowEnd = std::min(rows, rowBegin + TILE_ROWS);
+        std::size_t columnEnd = std::min(columns, columnBegin + TILE_COLUMNS);
+        __int128 sums[TILE_ROWS][TILE_COLUMNS] = {};
+        bool overflowed[TILE_ROWS][TILE_COLUMNS] = {};
+        for (std::size_t depthBegin = 0; depthBegin < depth; depthBegin += TILE_DEPTH) {
+            std::size_t count = std::min(depth - depthBegin, TILE_DEPTH);
+            auto countBits = static_cast<unsigned>(std::bit_width(count));
+            for (std::size_t row = rowBegin; row < rowEnd; ++row) {
+                const std::int64_t *a = &scaledRows.values[row * depth + depthBegin];
+                for (std::size_t column = columnBegin; column < columnEnd; ++column) {
+                    bool &failed = overflowed[row - rowBegin][column - columnBegin];
+                    if (failed) continue;
+                    const std::int64_t *b = &scaledColumns.values[column * depth + depthBegin];
+                    __int128 partial;
+                    if (scaledRows.bits[row] + scaledColumns.bits[column] + countBits <= 63) {
+                        partial = narrowDot(a, b, count);
+                    } else if (!wideDot(a, b, count, partial)) {
+                        failed = true;
+                        continue;
+                    }
+                    __int128 &sum = sums[row - rowBegin][column - columnBegin];
+                    failed = __builtin_add_overflow(sum, partial, &sum);
+                }
+            }
+        }
+        for (std::size_t row = rowBegin; row < rowEnd; ++row) {
+            for (std::size_t column = columnBegin; column < columnEnd; ++column) {
+                std::int64_t rowScale = scaledRows.scales[row];
+                std::int64_t columnScale = scaledColumns.scales[column];
+                if (rowScale == 0 || columnScale == 0 || overflowed[row - rowBegin][column - columnBegin]) {
+                    result(row, column) = bigDot(left, right, row, column);
+                } else {
+                    result(row, column) = reduceWide(sums[row - rowBegin][column - columnBegin],
+                                                     static_cast<__int128>(rowScale) * columnScale);
+                }
+            }
+        }
+    };
+
+    std::size_t tileColumns = (columns + TILE_COLUMNS - 1) / TILE_COLUMNS;
+    std::size_t tiles = (rows + TILE_ROWS - 1) / TILE_ROWS * tileColumns;
+    parallelFor(tiles, rows * columns * depth < PARALLEL_GRAIN ? 1 : workerCount(threads), [&](std::size_t tile) {
+        computeTile(tile / tileColumns * TILE_ROWS, tile % tileColumns * TILE_COLUMNS);
+    });
+    return result;
+}
+
+FractionMatrix operator*(const FractionMatrix &left, const FractionMatrix &right) {
+    return FractionMatrix::multiply(left, right);
+}
+
+/**
+ * The moduli of the multi-modular methods are primes between 2^30 and 2^31, so that a residue times a residue plus a
+ * residue fits in a uint64_t and reduces with one 64-bit remainder.
+ */
+static const std::uint64_t MODULAR_PRIME_LIMIT = std::uint64_t{1} << 31U;
+static const std::size_t MODULAR_PRIME_BITS = 30;
+
+static std::uint64_t powMod(std::uint64_t base, std::uint64_t exponent, std::uint64_t prime) {
+    std::uint64_t result = 1;
+    for (base %= prime; exponent != 0; exponent >>= 1U) {
+        if ((exponent & 1U) != 0) result = result * base % prime;
+        base = base * base % prime;
+    }
+    return result;
+}
+
+/**
+ * Miller-Rabin with the bases 2, 7 and 61, which is deterministic below 2^32.
+ */
+static bool isPrime(std::uint64_t n) {
+    if (n < 2 || n % 2 == 0) return n == 2;
+    std::uint64_t odd = n - 1;
+    unsigned twos = 0;
+    for (; odd % 2 == 0; odd /= 2) ++twos;
+    for (std::uint64_t base: {2U, 7U, 61U}) {
+        if (base % n == 0) continue;
+        std::uint64_t x = powMod(base, odd, n);
+        if (x == 1 || x == n - 1) continue;
+        bool composite = true;
+        for (unsigned i = 1; i < twos && composite; ++i) {
+            x = x * x % n;
+            composite = x != n - 1;
+        }
+        if (composite) return false;
+    }
+    return true;
+}
+
+/**
+ * Extends primes with the next count primes below the last one, or below MODULAR_PRIME_LIMIT when it is empty.
+ */
+static void appendPrimes(std::vector<std::uint64_t> &primes, std::size_t count) {
+    std::uint64_t candidate = primes.empty() ? MODULAR_PRIME_LIMIT - 1 : primes.back() - 2;
+    for (; count > 0; candidate -= 2) {
+        if (!isPrime(candidate)) continue;
+        primes.push_back(candidate);
+        --count;
+    }
+}
+
+/**
+ * @return value mod prime, in [0, prime).
+ */
+static std::uint64_t residue(const BigInt &value, std::uint64_t prime) {
+    auto signedPrime = static_cast<std::int64_t>(prime);
+    std::int64_t rest = value.fitsInt64() ? value.toInt64() % signedPrime
+                                          : (value % BigInt(signedPrime)).toInt64();
+    return static_cast<std::uint64_t>(rest < 0 ? rest + signedPrime : rest);
+}
+
+/**
+ * Reduces a matrix of Fractions, with rhs appended as a last column when given, mod prime. The denominators are
+ * inverted together with a single modular inverse (Montgomery's batch inversion), so that the entries need no
+ * BigInt scaling.
+ * @param reduced Receives the residues in row-major order.
+ * @return false if prime divides a denominator, which makes the prime unusable for this matrix.
+ */
+static bool reduceModulo(const FractionMatrix &matrix, const std::vector<Fraction> *rhs, std::uint64_t prime,
+                         std::vector<std::uint64_t> &reduced) {
+    std::size_t columns = matrix.columns();
+    std::size_t width = columns + (rhs != nullptr ? 1 : 0);
+    auto entry = [&](std::size_t index) -> const Fraction & {
+        std::size_t row = index / width;
+        std::size_t column = index % width;
+        return column < columns ? matrix(row, column) : (*rhs)[row];
+    };
+    std::size_t count = matrix.rows() * width;
+    reduced.resize(count);
+    std::uint64_t product = 1;
+    for (std::size_t index = 0; index < count; ++index) {
+        reduced[index] = product;
+        product = product * static_cast<std::uint64_t>(entry(index).getDenominator()) % prime;
+        if (product == 0) return false;
+    }
+    std::uint64_t inverse = powMod(product, prime - 2, prime);
+    for (std::size_t index = count; index-- > 0;) {
+        const Fraction &fraction = entry(index);
+        std::uint64_t denominatorInverse = inverse * reduced[index] % prime;
+        inverse = inverse * static_cast<std::uint64_t>(fraction.getDenominator()) % prime;
+        auto signedPrime = static_cast<std::int64_t>(prime);
+        std::int64_t numerator = fraction.getNumerator() % signedPrime;
+        reduced[index] = static_cast<std::uint64_t>(numerator < 0 ? numerator + signedPrime : numerator) *
+                         denominatorInverse % prime;
+    }
+    return true;
+}
+
+/**
+ * A bound, in bits, on the determinant of any square matrix built from columns of a rows x width integer matrix, by
+ * Hadamard's inequality: the product of the row norms, each at most sqrt(width) times the row's largest entry.
+ */
+static std::size_t hadamardBits(const std::vector<BigInt> &a, std::size_t rows, std::size_t width) {
+    std::size_t bits = 0;
+    for (std::size_t row = 0; row < rows; ++row) {
+        std::size_t largest = 0;
+        for (std::size_t column = 0; column < width; ++column) {
+            largest = std::max(largest, a[row * width + column].bitLength());
+        }
+        bits += largest + static_cast<std::size_t>(std::bit_width(width) + 1) / 2;
+    }
+    return bits;
+}
+
+/**
+ * Gaussian elimination mod prime, in place, on an n x n matrix of residues.
+ * @return The determinant mod prime.
+ */
+static std::uint64_t determinantModulo(std::vector<std::uint64_t> &a, std::size_t n, std::uint64_t prime) {
+    std::uint64_t determinant = 1;
+    for (std::size_t column = 0; column < n; ++column) {
+        std::size_t pivotRow = column;
+        while (pivotRow < n && a[pivotRow * n + column] == 0) ++pivotRow;
+        if (pivotRow == n) return 0;
+        if (pivotRow != column) {
+            std::swap_ranges(a.begin() + static_cast<std::ptrdiff_t>(pivotRow * n),
+                             a.begin() + static_cast<std::ptrdiff_t>((pivotRow + 1) * n),
+                             a.begin() + static_cast<std::ptrdiff_t>(column * n));
+            determinant = prime - determinant;
+        }
+        std::uint64_t pivot = a[column * n + column];
+        determinant = determinant * pivot % prime;
+        std::uint64_t inverse = powMod(pivot, prime - 2, prime);
+        for (std::size_t row = column + 1; row < n; ++row) {
+            std::uint64_t factor = prime - a[row * n + column] * inverse % prime;
+            if (factor == prime) continue;
+            for (std::size_t j = column + 1; j < n; ++j) {
+                a[row * n + j] = (a[row * n + j] + factor * a[column * n + j]) % prime;
+            }
+        }
+    }
+    return determinant;
+}
+
+/**
+ * Gauss-Jordan elimination mod prime, in place, on an n x (n + 1) augmented system of residues.
+ * @param solution Receives the solution mod prime.
+ * @param determinant Receives the determinant of the matrix mod prime.
+ * @return false if the matrix is singular mod prime.
+ */
+static bool solveModulo(std::vector<std::uint64_t> &a, std::size_t n, std::uint64_t prime,
+                        std::vector<std::uint64_t> &solution, std::uint64_t &determinant) {
+    std::size_t width = n + 1;
+    determinant = 1;
+    for (std::size_t column = 0; column < n; ++column) {
+        std::size_t pivotRow = column;
+        while (pivotRow < n && a[pivotRow * width + column] == 0) ++pivotRow;
+        if (pivotRow == n) return false;
+        if (pivotRow != column) {
+            std::swap_ranges(a.begin() + static_cast<std::ptrdiff_t>(pivotRow * width),
+                             a.begin() + static_cast<std::ptrdiff_t>((pivotRow + 1) * width),
+                             a.begin() + static_cast<std::ptrdiff_t>(column * width));
+            determinant = prime - determinant;
+        }
+        determinant = determinant * a[column * width + column] % prime;
+        std::uint64_t inverse = powMod(a[column * width + column], prime - 2, prime);
+        for (std::size_t j = column; j < width; ++j) a[column * width + j] = a[column * width + j] * inverse % prime;
+        for (std::size_t row = 0; row < n; ++row) {
+            if (row == column || a[row * width + column] == 0) continue;
+            std::uint64_t factor = prime - a[row * width + column];
+            for (std::size_t j = column; j < width; ++j) {
+                a[row * width + j] = (a[row * width + j] + factor * a[column * width + j]) % prime;
+            }
+        }
+    }
+    solution.resize(n);
+    for (std::size_t row = 0; row < n; ++row) solution[row] = a[row * width + n];
+    return true;
+}
+
+/**
+ * Chinese remaindering, one prime at a time: updates value mod modulus to the value mod modulus * prime that is
+ * congruent to rest mod prime. The caller multiplies modulus by prime afterwards.
+ */
+static void combineResidue(BigInt &value, const BigInt &modulus, std::uint64_t modulusInverse, std::uint64_t rest,
+                           std::uint64_t prime) {
+    std::uint64_t difference = (rest + prime - residue(value, prime)) % prime;
+    value += modulus * BigInt(static_cast<std::int64_t>(difference * modulusInverse % prime));
+}
+
+/**
+ * Maps value mod modulus to the representative of least magnitude.
+ * @return Whether that representative is more than a prime's worth of bits below the modulus, which it stays for
+ * every further prime once it is the true value, and which a value still changing under CRT misses with probability
+ * about 2^-30.
+ */
+static bool settled(const BigInt &value, const BigInt &modulus, BigInt &result) {
+    result = value * BigInt(2) > modulus ? value - modulus : value;
+    return result.bitLength() + MODULAR_PRIME_BITS < modulus.bitLength();
+}
+
+/**
+ * Computes the determinant modulo enough primes to exceed twice the Hadamard bound of the scaled matrix, one prime per
+ * task across the threads, and combines the residues by the Chinese remainder theorem into the exact integer
+ * determinant of the scaled matrix. Primes dividing a denominator are skipped.
+ * @param threads The number of threads to use; 0 uses std::thread::hardware_concurrency().
+ * @throws std::invalid_argument If the matrix is not square.
+ * @return The exact determinant, equal to determinant().
+ */
+BigFraction FractionMatrix::modularDeterminant(unsigned threads) const {
+    if (!isSquare()) throw std::invalid_argument("Matrix is not square");
+    std::vector<BigInt> scales;
+    std::vector<BigInt> scaled = scaleRows(*this, nullptr, 0, scales);
+    BigInt scale = 1;
+    for (const BigInt &rowScale: scales) scale *= rowScale;
+    std::size_t needed = (hadamardBits(scaled, rowCount, columnCount) + 1) / MODULAR_PRIME_BITS + 1;
+
+    std::vector<std::uint64_t> primes;
+    BigInt determinant = 0;
+    BigInt modulus = 1;
+    std::size_t combined = 0;
+    while (combined < needed) {
+        std::size_t first = primes.size();
+        appendPrimes(primes, needed - combined);
+        std::vector<std::uint64_t> determinants(primes.size() - first);
+        std::vector<char> usable(primes.size() - first);
+        parallelFor(determinants.size(), workerCount(threads), [&](std::size_t index) {
+            std::uint64_t prime = primes[first + index];
+            std::vector<std::uint64_t> reduced;
+            usable[index] = reduceModulo(*this, nullptr, prime, reduced);
+            if (usable[index] != 0) {
+                determinants[index] = determinantModulo(reduced, rowCount, prime) * residue(scale, prime) % prime;
+            }
+        });
+        for (std::size_t index = 0; index < determinants.size(); ++index) {
+            if (usable[index] == 0) continue;
+            std::uint64_t prime = primes[first + index];
+            combineResidue(determinant, modulus, powMod(residue(modulus, prime), prime - 2, prime),
+                           determinants[index], prime);
+            modulus *= BigInt(static_cast<std::int64_t>(prime));
+            ++combined;
+        }
+    }
+    if (determinant * BigInt(2) > modulus) determinant -= modulus;
+    return {determinant, scale};
+}
+
+/**
+ * Solves A x = rhs modulo a growing set of primes, a batch of one prime per thread at a time. With A and rhs scaled
+ * free of denominators, d = det(A) and the Cramer numerators y = d x are integers; each prime contributes their
+ * residues, from the solution and determinant mod prime, and the Chinese remainder theorem lifts them. Once d and
+ * every y_i have settled below the growing modulus, the candidate x = y / d is accepted if it satisfies the scaled
+ * system exactly, so the number of primes follows the actual size of the solution rather than its Hadamard bound.
+ * Primes dividing a denominator or the determinant are skipped; once the primes the matrix is singular modulo exceed
+ * the Hadamard bound, the determinant is 0.
+ * @param threads The number of threads to use; 0 uses std::thread::hardware_concurrency().
+ * @throws std::invalid_argument If the matrix is not square or rhs does not have one entry per row.
+ * @throws std::runtime_error If the matrix is singular.
+ * @return The unique solution x, equal to solve(rhs).
+ */
+std::vector<BigFraction> FractionMatrix::modularSolve(const std::vector<Fraction> &rhs, unsigned threads) const {
+    if (!isSquare()) throw std::invalid_argument("Matrix is not square");
+    if (rhs.size() != rowCount) throw std::invalid_argument("Matrix dimensions do not match");
+    std::size_t n = rowCount;
+    std::size_t width = n + 1;
+    std::vector<BigInt> scales;
+    std::vector<BigInt> scaled = scaleSystem(*this, rhs, scales);
+    BigInt scale = 1;
+    for (const BigInt &rowScale: scales) scale *= rowScale;
+    std::size_t singularBound = hadamardBits(scaled, n, width) + 1;
+    std::size_t workers = workerCount(threads);
+
+    std::vector<std::uint64_t> primes;
+    // The Cramer numerators y_0 ... y_{n-1}, then the determinant d, all mod modulus.
+    std::vector<BigInt> values(n + 1);
+    BigInt modulus = 1;
+    std::size_t singularBits = 0;
+    std::vector<BigInt> lifted(n + 1);
+    while (true) {
+        std::size_t first = primes.size();
+        appendPrimes(primes, workers);
+        std::vector<std::vector<std::uint64_t>> rests(workers);
+        std::vector<char> usable(workers);
+        std::vector<char> solved(workers);
+        parallelFor(workers, workers, [&](std::size_t index) {
+            std::uint64_t prime = primes[first + index];
+            std::vector<std::uint64_t> reduced;
+            usable[index] = reduceModulo(*this, &rhs, prime, reduced);
+            if (usable[index] == 0) return;
+            std::uint64_t determinant = 0;
+            solved[index] = solveModulo(reduced, n, prime, rests[index], determinant);
+            if (solved[index] == 0) return;
+            determinant = determinant * residue(scale, prime) % prime;
+            for (std::uint64_t &rest: rests[index]) rest = rest * determinant % prime;
+            rests[index].push_back(determinant);
+        });
+        for (std::size_t index = 0; index < workers; ++index) {
+            std::uint64_t prime = primes[first + index];
+            if (usable[index] == 0) continue;
+            if (solved[index] == 0) {
+                singularBits += MODULAR_PRIME_BITS;
+                if (singularBits > singularBound) throw std::runtime_error("Matrix is singular");
+                continue;
+            }
+            std::uint64_t modulusInverse = powMod(residue(modulus, prime), prime - 2, prime);
+            for (std::size_t i = 0; i <= n; ++i) {
+                combineResidue(values[i], modulus, modulusInverse, rests[index][i], prime);
+            }
+            modulus *= BigInt(static_cast<std::int64_t>(prime));
+        }
+
+        if (!settled(values[n], modulus, lifted[n])) continue;
+        bool candidate = true;
+        for (std::size_t i = 0; i < n && candidate; ++i) candidate = settled(values[i], modulus, lifted[i]);
+        if (!candidate) continue;
+        bool satisfied = true;
+        for (std::size_t row = 0; row < n && satisfied; ++row) {
+            BigInt sum = 0;
+            for (std::size_t column = 0; column < n; ++column) sum += scaled[row * width + column] * lifted[column];
+            satisfied = sum == scaled[row * width + n] * lifted[n];
+        }
+        if (!satisfied) continue;
+        std::vector<BigFraction> solution;
+        solution.reserve(n);
+        for (std::size_t i = 0; i < n; ++i) solution.emplace_back(lifted[i], lifted[n]);
+        return solution;
+    }
+}
+
+/**
+ * Writes one row per line, with the entries separated by spaces.
+ */
+std::ostream &operator<<(std::ostream &outstream, const FractionMatrix &matrix) {
+    for (std::size_t row = 0; row < matrix.rows(); ++row) {
+        for (std::size_t column = 0; column < matrix.columns(); ++column) {
+            if (column > 0) outstream << ' ';
+            outstream << matrix(row, column);
+        }
+        outstream << '\n';
+    }
+    return outstream;
+}
+
+bool operator==(const FractionMatrix &left, const FractionMatrix &right) {
+    return left.rowCount == right.rowCount && left.columnCount == right.columnCount && left.entries == right.entries;
+}
+
+bool operator!=(const FractionMatrix &left, const FractionMatrix &right) {
+    return !(left == right);
+}
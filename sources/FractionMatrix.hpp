@@ -0,0 +1,82 @@
+#ifndef FRACTION_FRACTION_MATRIX_HPP
+#define FRACTION_FRACTION_MATRIX_HPP
+
+#include <cstddef>
+#include <initializer_list>
+#include <iostream>
+#include <vector>
+
+#include "BigFraction.hpp"
+#include "Fraction.hpp"
+
+/**
+ * A dense matrix of Fractions in contiguous row-major storage, with exact linear algebra.
+ *
+ * Determinant, rank, solve and inverse clear the denominators of each row and run Bareiss' fraction-free elimination
+ * on BigInts: every intermediate entry is a minor of the scaled matrix, every division is exact, and the only
+ * fractions are built by one final division per result. Results that may outgrow Fraction are returned as
+ * BigFractions; inverse returns a FractionMatrix and throws if an entry does not fit.
+ *
+ * Products scale each row of the left matrix and each column of the right one to integers once, so every entry of the
+ * product is an integer dot product over a common denominator, reduced a single time.
+ *
+ * modularDeterminant and modularSolve compute the same results as determinant and solve from residues modulo many
+ * word-size primes, in parallel, recombined by the Chinese remainder theorem and rational reconstruction. They
+ * replace the growing BigInt minors of Bareiss by fixed-size arithmetic, and win on large systems.
+ */
+class FractionMatrix {
+
+private:
+
+    std::size_t rowCount = 0;
+    std::size_t columnCount = 0;
+    std::vector<Fraction> entries;
+
+public:
+
+    FractionMatrix();
+
+    FractionMatrix(std::size_t rows, std::size_t columns);
+
+    FractionMatrix(std::initializer_list<std::initializer_list<Fraction>> rows);
+
+    static FractionMatrix identity(std::size_t size);
+
+    [[nodiscard]] std::size_t rows() const;
+
+    [[nodiscard]] std::size_t columns() const;
+
+    [[nodiscard]] bool isSquare() const;
+
+    Fraction &operator()(std::size_t row, std::size_t column);
+
+    const Fraction &operator()(std::size_t row, std::size_t column) const;
+
+    Fraction *data();
+
+    [[nodiscard]] const Fraction *data() const;
+
+    [[nodiscard]] BigFraction determinant() const;
+
+    [[nodiscard]] std::size_t rank() const;
+
+    [[nodiscard]] std::vector<BigFraction> solve(const std::vector<Fraction> &rhs) const;
+
+    [[nodiscard]] FractionMatrix inverse() const;
+
+    [[nodiscard]] BigFraction modularDeterminant(unsigned threads = 0) const;
+
+    [[nodiscard]] std::vector<BigFraction> modularSolve(const std::vector<Fraction> &rhs, unsigned threads = 0) const;
+
+    static FractionMatrix multiply(const FractionMatrix &left, const FractionMatrix &right, unsigned threads = 0);
+
+    friend FractionMatrix operator*(const FractionMatrix &left, const FractionMatrix &right);
+
+    friend std::ostream &operator<<(std::ostream &outstream, const FractionMatrix &matrix);
+
+    friend bool operator==(const FractionMatrix &left, const FractionMatrix &right);
+
+    friend bool operator!=(const FractionMatrix &left, const FractionMatrix &right);
+};
+
+#endif
@@ -0,0 +1,204 @@
+#include "FractionSort.hpp"
+
+#include <algorithm>
+#include <array>
+#include <barrier>
+#include <thread>
+
+/**
+ * Elements below this count are sorted with std::stable_sort; radix passes do not pay off for them.
+ */
+static const std::size_t RADIX_THRESHOLD = 256;
+
+/**
+ * Below this count per thread the parallel sort falls back to the sequential one.
+ */
+static const std::size_t PARALLEL_GRAIN = 1U << 16U;
+
+static const std::size_t RADIX_BITS = 8;
+static const std::size_t RADIX_BUCKETS = std::size_t{1} << RADIX_BITS;
+static const std::size_t RADIX_PASSES = 64 / RADIX_BITS;
+
+using Histogram = std::array<std::array<std::size_t, RADIX_BUCKETS>, RADIX_PASSES>;
+
+struct KeyedFraction {
+    std::uint64_t key;
+    Fraction value;
+};
+
+/**
+ * Compares two fractions exactly by cross-multiplying in 64-bit arithmetic, without any gcd.
+ * @param first The first fraction.
+ * @param second The second fraction.
+ * @return A negative number, zero or a positive number as first is less than, equal to or greater than second.
+ */
+int compareFractions(const Fraction &first, const Fraction &second) {
+    std::int64_t left = std::int64_t{first.getNumerator()} * second.getDenominator();
+    std::int64_t right = std::int64_t{second.getNumerator()} * first.getDenominator();
+    return (left > right) - (left < right);
+}
+
+/**
+ * Computes an order-preserving 64-bit key: floor(numerator * 2^32 / denominator) with the sign bit flipped so that
+ * unsigned key order is value order.
+ * Equal fractions get equal keys; distinct fractions closer than 2^-32 may share a key, so a sort by key alone must
+ * be followed by an exact tie-break.
+ * @param fraction The fraction to key.
+ * @return The sort key.
+ */
+std::uint64_t fractionSortKey(const Fraction &fraction) {
+    __int128 scaled = static_cast<__int128>(fraction.getNumerator()) << 32U;
+    __int128 denominator = fraction.getDenominator();
+    __int128 quotient = scaled / denominator;
+    if (scaled % denominator != 0 && scaled < 0) --quotient;
+    return static_cast<std::uint64_t>(static_cast<std::int64_t>(quotient)) ^ (std::uint64_t{1} << 63U);
+}
+
+static bool lessByValue(const Fraction &first, const Fraction &second) {
+    return compareFractions(first, second) < 0;
+}
+
+static std::size_t digit(std::uint64_t key, std::size_t pass) {
+    return static_cast<std::size_t>(key >> (pass * RADIX_BITS)) & (RADIX_BUCKETS - 1);
+}
+
+/**
+ * Keys a range of fractions and counts the digits of every pass.
+ */
+static void keyRange(const Fraction *source, KeyedFraction *target, std::size_t count, Histogram &histogram) {
+    for (auto &counts: histogram) counts.fill(0);
+    for (std::size_t i = 0; i < count; ++i) {
+        std::uint64_t key = fractionSortKey(source[i]);
+        target[i] = {key, source[i]};
+        for (std::size_t pass = 0; pass < RADIX_PASSES; ++pass) ++histogram[pass][digit(key, pass)];
+    }
+}
+
+/**
+ * A pass is skipped when every key has the same digit in it, which is common for the high digits of small values.
+ */
+static bool trivialPass(const std::array<std::size_t, RADIX_BUCKETS> &counts, std::size_t total) {
+    return std::any_of(counts.begin(), counts.end(), [total](std::size_t count) { return count == total; });
+}
+
+/**
+ * Sorts runs of equal keys exactly. Such runs hold equal values or values closer than 2^-32 and are almost always
+ * short.
+ */
+static void breakTies(std::vector<Fraction> &fractions, const std::vector<KeyedFraction> &sorted) {
+    std::size_t count = sorted.size();
+    for (std::size_t i = 0; i < count; ++i) fractions[i] = sorted[i].value;
+    for (std::size_t start = 0; start < count;) {
+        std::size_t end = start + 1;
+        while (end < count && sorted[end].key == sorted[start].key) ++end;
+        if (end - start > 1) {
+            std::stable_sort(fractions.begin() + static_cast<std::ptrdiff_t>(start),
+                             fractions.begin() + static_cast<std::ptrdiff_t>(end), lessByValue);
+        }
+        start = end;
+    }
+}
+
+/**
+ * Sorts fractions by value with an LSD radix sort on fractionSortKey followed by an exact tie-break, so the cost is a
+ * fixed number of linear passes instead of O(n log n) comparisons. The sort is stable.
+ * @param fractions The fractions to sort in place.
+ */
+void radixSortFractions(std::vector<Fraction> &fractions) {
+    std::size_t count = fractions.size();
+    if (count < RADIX_THRESHOLD) {
+        std::stable_sort(fractions.begin(), fractions.end(), lessByValue);
+        return;
+    }
+
+    std::vector<KeyedFraction> items(count);
+    std::vector<KeyedFraction> buffer(count);
+    Histogram histogram{};
+    keyRange(fractions.data(), items.data(), count, histogram);
+
+    for (std::size_t pass = 0; pass < RADIX_PASSES; ++pass) {
+        if (trivialPass(histogram[pass], count)) continue;
+        std::array<std::size_t, RADIX_BUCKETS> offsets{};
+        std::size_t offset = 0;
+        for (std::size_t bucket = 0; bucket < RADIX_BUCKETS; ++bucket) {
+            offsets[bucket] = offset;
+            offset += histogram[pass][bucket];
+        }
+        for (const KeyedFraction &item: items) buffer[offsets[digit(item.key, pass)]++] = item;
+        items.swap(buffer);
+    }
+    breakTies(fractions, items);
+}
+
+/**
+ * Parallel variant of radixSortFractions. Each thread keys and histograms a contiguous chunk once; every pass then
+ * scatters the chunks concurrently into offsets computed from all chunks' histograms, which keeps the sort stable.
+ * @param fractions The fractions to sort in place.
+ * @param threads The number of threads to use; 0 uses std::thread::hardware_concurrency().
+ */
+void parallelRadixSortFractions(std::vector<Fraction> &fractions, unsigned threads) {
+    std::size_t count = fractions.size();
+    std::size_t workers = threads == 0 ? std::max(1U, std::thread::hardware_concurrency()) : threads;
+    workers = std::min(workers, count / PARALLEL_GRAIN);
+    if (workers <= 1) {
+        radixSortFractions(fractions);
+        return;
+    }
+
+    std::vector<KeyedFraction> items(count);
+    std::vector<KeyedFraction> buffer(count);
+    std::vector<Histogram> histograms(workers);
+    std::vector<std::size_t> bounds(workers + 1);
+    for (std::size_t worker = 0; worker <= workers; ++worker) bounds[worker] = count * worker / workers;
+
+    std::barrier sync(static_cast<std::ptrdiff_t>(workers));
+    KeyedFraction *sorted = nullptr;
+    auto work = [&](std::size_t worker) {
+        std::size_t begin = bounds[worker];
+        std::size_t end = bounds[worker + 1];
+        keyRange(fractions.data() + begin, items.data() + begin, end - begin, histograms[worker]);
+        sync.arrive_and_wait();
+
+        KeyedFraction *from = items.data();
+        KeyedFraction *to = buffer.data();
+        for (std::size_t pass = 0; pass < RADIX_PASSES; ++pass) {
+            std::array<std::size_t, RADIX_BUCKETS> totals{};
+            for (const Histogram &histogram: histograms) {
+                for (std::size_t bucket = 0; bucket < RADIX_BUCKETS; ++bucket) {
+                    totals[bucket] += histogram[pass][bucket];
+                }
+            }
+            if (trivialPass(totals, count)) continue;
+
+            std::array<std::size_t, RADIX_BUCKETS> offsets{};
+            std::size_t offset = 0;
+            for (std::size_t bucket = 0; bucket < RADIX_BUCKETS; ++bucket) {
+                offsets[bucket] = offset;
+                for (std::size_t other = 0; other < worker; ++other) {
+                    offsets[bucket] += histograms[other][pass][bucket];
+                }
+                offset += totals[bucket];
+            }
+
+            // A pass moves elements between chunks, so the histograms of the next pass are recounted per chunk.
+            for (std::size_t i = begin; i < end; ++i) to[offsets[digit(from[i].key, pass)]++] = from[i];
+            sync.arrive_and_wait();
+            for (auto &counts: histograms[worker]) counts.fill(0);
+            for (std::size_t i = begin; i < end; ++i) {
+                for (std::size_t later = pass + 1; later < RADIX_PASSES; ++later) {
+                    ++histograms[worker][later][digit(to[i].key, later)];
+                }
+            }
+            std::swap(from, to);
+            sync.arrive_and_wait();
+        }
+        if (worker == 0) sorted = from;
+    };
+
+    std::vector<std::thread> pool;
+    for (std::size_t worker = 1; worker < workers; ++worker) pool.emplace_back(work, worker);
+    work(0);
+    for (std::thread &thread: pool) thread.join();
+    if (sorted != items.data()) items.swap(buffer);
+    breakTies(fractions, items);
+}
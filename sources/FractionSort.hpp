@@ -0,0 +1,18 @@
+#ifndef FRACTION_SORT_HPP
+#define FRACTION_SORT_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "Fraction.hpp"
+
+int compareFractions(const Fraction &first, const Fraction &second);
+
+std::uint64_t fractionSortKey(const Fraction &fraction);
+
+void radixSortFractions(std::vector<Fraction> &fractions);
+
+void parallelRadixSortFractions(std::vector<Fraction> &fractions, unsigned threads = 0);
+
+#endif
@@ -0,0 +1,97 @@
+#include "FractionStats.hpp"
+
+#include <algorithm>
+#include <mutex>
+#include <vector>
+
+/**
+ * Registry of the counter blocks of all live threads, plus the totals of threads that have already exited.
+ */
+struct FractionStatsRegistry {
+    std::mutex mutex;
+    std::vector<FractionThreadCounters *> live;
+    std::array<std::uint64_t, FRACTION_COUNTER_COUNT> retired{};
+};
+
+static FractionStatsRegistry &registry() {
+    static FractionStatsRegistry instance;
+    return instance;
+}
+
+/**
+ * Registers the calling thread's counter block so that snapshots can see it.
+ */
+FractionThreadCounters::FractionThreadCounters() {
+    FractionStatsRegistry &reg = registry();
+    std::lock_guard<std::mutex> lock(reg.mutex);
+    reg.live.push_back(this);
+}
+
+/**
+ * Folds the exiting thread's counts into the retired totals and unregisters its counter block.
+ */
+FractionThreadCounters::~FractionThreadCounters() {
+    FractionStatsRegistry &reg = registry();
+    std::lock_guard<std::mutex> lock(reg.mutex);
+    for (std::size_t i = 0; i < FRACTION_COUNTER_COUNT; ++i) {
+        reg.retired[i] += counts[i].load(std::memory_order_relaxed);
+    }
+    reg.live.erase(std::remove(reg.live.begin(), reg.live.end(), this), reg.live.end());
+}
+
+/**
+ * Sums the counters of every live thread and of every thread that has exited since the last reset.
+ * @return The aggregated counters; all zero when the library was compiled without FRACTION_STATS.
+ */
+FractionStatsSnapshot FractionStats::snapshot() {
+    FractionStatsSnapshot result;
+    FractionStatsRegistry &reg = registry();
+    std::lock_guard<std::mutex> lock(reg.mutex);
+    result.counts = reg.retired;
+    for (const FractionThreadCounters *counters: reg.live) {
+        for (std::size_t i = 0; i < FRACTION_COUNTER_COUNT; ++i) {
+            result.counts[i] += counters->counts[i].load(std::memory_order_relaxed);
+        }
+    }
+    return result;
+}
+
+/**
+ * Zeroes all counters. Increments racing with a reset from other threads may survive it.
+ */
+void FractionStats::reset() {
+    FractionStatsRegistry &reg = registry();
+    std::lock_guard<std::mutex> lock(reg.mutex);
+    reg.retired.fill(0);
+    for (FractionThreadCounters *counters: reg.live) {
+        for (std::atomic<std::uint64_t> &count: counters->counts) {
+            count.store(0, std::memory_order_relaxed);
+        }
+    }
+}
+
+/**
+ * @param counter The counter to name.
+ * @return A short stable name for the counter, suitable for logs and benchmark output.
+ */
+const char *FractionStats::name(FractionCounter counter) {
+    switch (counter) {
+        case FractionCounter::Construction:
+            return "construction";
+        case FractionCounter::Renormalisation:
+            return "renormalisation";
+        case FractionCounter::Gcd:
+            return "gcd";
+        case FractionCounter::FloatConversion:
+            return "float_conversion";
+        case FractionCounter::AddOverflow:
+            return "add_overflow";
+        case FractionCounter::SubOverflow:
+            return "sub_overflow";
+        case FractionCounter::MulOverflow:
+            return "mul_overflow";
+        case FractionCounter::Count:
+            break;
+    }
+    return "unknown";
+}
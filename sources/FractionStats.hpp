@@ -0,0 +1,86 @@
+#ifndef FRACTION_STATS_HPP
+#define FRACTION_STATS_HPP
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * Operation counters collected by the Fraction hot paths when the library is compiled with FRACTION_STATS defined.
+ * Without FRACTION_STATS the FRACTION_COUNT macro expands to nothing and the counters always read zero.
+ */
+enum class FractionCounter : std::size_t {
+    Construction,
+    Renormalisation,
+    Gcd,
+    FloatConversion,
+    AddOverflow,
+    SubOverflow,
+    MulOverflow,
+    Count
+};
+
+const std::size_t FRACTION_COUNTER_COUNT = static_cast<std::size_t>(FractionCounter::Count);
+
+/**
+ * A point-in-time copy of the counters, summed over every thread that ever counted.
+ */
+struct FractionStatsSnapshot {
+    std::array<std::uint64_t, FRACTION_COUNTER_COUNT> counts{};
+
+    [[nodiscard]] std::uint64_t operator[](FractionCounter counter) const {
+        return counts[static_cast<std::size_t>(counter)];
+    }
+};
+
+/**
+ * Per-thread counter block. Only the owning thread writes to it, so an increment is a relaxed load and store;
+ * the atomics only make concurrent snapshots well defined.
+ */
+struct FractionThreadCounters {
+    std::array<std::atomic<std::uint64_t>, FRACTION_COUNTER_COUNT> counts{};
+
+    FractionThreadCounters();
+
+    ~FractionThreadCounters();
+
+    FractionThreadCounters(const FractionThreadCounters &) = delete;
+
+    FractionThreadCounters &operator=(const FractionThreadCounters &) = delete;
+
+    FractionThreadCounters(FractionThreadCounters &&) = delete;
+
+    FractionThreadCounters &operator=(FractionThreadCounters &&) = delete;
+};
+
+class FractionStats {
+
+public:
+
+#ifdef FRACTION_STATS
+    static constexpr bool enabled = true;
+#else
+    static constexpr bool enabled = false;
+#endif
+
+    static void increment(FractionCounter counter) {
+        static thread_local FractionThreadCounters local;
+        std::atomic<std::uint64_t> &slot = local.counts[static_cast<std::size_t>(counter)];
+        slot.store(slot.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+    }
+
+    static FractionStatsSnapshot snapshot();
+
+    static void reset();
+
+    static const char *name(FractionCounter counter);
+};
+
+#ifdef FRACTION_STATS
+#define FRACTION_COUNT(counter) FractionStats::increment(FractionCounter::counter)
+#else
+#define FRACTION_COUNT(counter) ((void) 0)
+#endif
+
+#endif
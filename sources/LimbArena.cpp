@@ -0,0 +1,45 @@
+#include "LimbArena.hpp"
+
+#include <memory>
+#include <optional>
+
+/**
+ * The calling thread's arena. The first chunk is a buffer the thread keeps between scopes, so a batch that fits in it
+ * never reaches the upstream allocator; the monotonic resource itself is rebuilt by each outermost scope, which is
+ * cheap because it only records the buffer.
+ */
+struct ThreadArena {
+    std::unique_ptr<std::byte[]> buffer;
+    std::size_t bufferSize = 0;
+    std::optional<std::pmr::monotonic_buffer_resource> chunks;
+    std::size_t depth = 0;
+};
+
+static thread_local ThreadArena threadArena;
+
+/**
+ * Opens a scope, activating the thread's arena if this is the outermost one.
+ * @param upstream Where the arena obtains chunks beyond its retained buffer; only used by the outermost scope.
+ * @param initialSize The minimum size of the retained buffer; later chunks grow geometrically.
+ */
+ArenaScope::ArenaScope(std::pmr::memory_resource *upstream, std::size_t initialSize) {
+    if (threadArena.depth++ == 0) {
+        if (threadArena.bufferSize < initialSize) {
+            threadArena.buffer = std::make_unique<std::byte[]>(initialSize);
+            threadArena.bufferSize = initialSize;
+        }
+        threadArena.chunks.emplace(threadArena.buffer.get(), threadArena.bufferSize, upstream);
+        LimbArena::arena = &*threadArena.chunks;
+    }
+}
+
+/**
+ * Closes the scope; the outermost one hands every chunk beyond the retained buffer back to the upstream allocator at
+ * once.
+ */
+ArenaScope::~ArenaScope() {
+    if (--threadArena.depth == 0) {
+        LimbArena::arena = nullptr;
+        threadArena.chunks.reset();
+    }
+}
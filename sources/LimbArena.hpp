@@ -0,0 +1,147 @@
+#ifndef FRACTION_LIMB_ARENA_HPP
+#define FRACTION_LIMB_ARENA_HPP
+
+#include <cstddef>
+#include <memory>
+#include <memory_resource>
+#include <type_traits>
+
+/**
+ * Per-thread arena for the scratch limb buffers of BigInt's multiplication, division and gcd.
+ *
+ * While an ArenaScope is alive on a thread, the temporaries those algorithms create on that thread, such as the pieces
+ * of a Karatsuba or Toom-3 split, the normalised operands of a long division and the working pair of Lehmer's gcd, are
+ * allocated from the thread's arena, a std::pmr::monotonic_buffer_resource: allocation is a pointer bump, deallocation
+ * is free, and nothing is returned to the upstream allocator until the outermost scope ends, when the whole arena is
+ * released in one step. Each thread keeps its first chunk between scopes, so batches that fit in it never touch the
+ * upstream allocator.
+ *
+ * The limbs of a BigInt value never come from the arena, so values may be moved, copied and kept across scopes freely.
+ */
+class LimbArena {
+
+private:
+
+    static inline thread_local std::pmr::memory_resource *arena = nullptr;
+
+    friend class ArenaScope;
+
+public:
+
+    /**
+     * @return The calling thread's arena while an ArenaScope is active, otherwise nullptr.
+     */
+    static std::pmr::memory_resource *current() {
+        return arena;
+    }
+
+    /**
+     * @return The calling thread's arena while an ArenaScope is active, otherwise the default memory resource, for
+     * use with std::pmr containers.
+     */
+    static std::pmr::memory_resource *resource() {
+        std::pmr::memory_resource *current = arena;
+        return current != nullptr ? current : std::pmr::get_default_resource();
+    }
+
+    static bool active() {
+        return arena != nullptr;
+    }
+};
+
+/**
+ * Activates the calling thread's limb arena for its lifetime. Scopes nest; the arena is released when the outermost
+ * scope ends, which is the bulk reset at the end of a batch.
+ */
+class ArenaScope {
+
+public:
+
+    explicit ArenaScope(std::pmr::memory_resource *upstream = std::pmr::new_delete_resource(),
+                        std::size_t initialSize = 64 * 1024);
+
+    ~ArenaScope();
+
+    ArenaScope(const ArenaScope &) = delete;
+
+    ArenaScope &operator=(const ArenaScope &) = delete;
+
+    ArenaScope(ArenaScope &&) = delete;
+
+    ArenaScope &operator=(ArenaScope &&) = delete;
+};
+
+/**
+ * Allocator for limb vectors: allocates from a std::pmr::memory_resource, or from the global heap when it holds none.
+ *
+ * A default-constructed allocator, and the copy a container makes of itself, allocates from the global heap; only
+ * scratch() binds to the calling thread's current arena. Unlike std::pmr::polymorphic_allocator it does not consult
+ * std::pmr::get_default_resource(), so constructing a BigInt costs nothing. Like polymorphic_allocator, it never
+ * propagates on copy assignment, move assignment or swap, so assigning scratch limbs into a value copies them to the
+ * heap; move construction takes the source's storage together with its allocator.
+ */
+template<class T>
+class LimbAllocator {
+
+private:
+
+    std::pmr::memory_resource *memory;
+
+    template<class U>
+    friend class LimbAllocator;
+
+public:
+
+    using value_type = T;
+    using propagate_on_container_copy_assignment = std::false_type;
+    using propagate_on_container_move_assignment = std::false_type;
+    using propagate_on_container_swap = std::false_type;
+
+    LimbAllocator() noexcept : memory(nullptr) {}
+
+    explicit LimbAllocator(std::pmr::memory_resource *memory) noexcept : memory(memory) {}
+
+    template<class U>
+    LimbAllocator(const LimbAllocator<U> &other) noexcept : memory(other.memory) {}
+
+    T *allocate(std::size_t count) {
+        if (memory == nullptr) return std::allocator<T>().allocate(count);
+        return static_cast<T *>(memory->allocate(count * sizeof(T), alignof(T)));
+    }
+
+    void deallocate(T *pointer, std::size_t count) {
+        if (memory == nullptr) {
+            std::allocator<T>().deallocate(pointer, count);
+        } else {
+            memory->deallocate(pointer, count * sizeof(T), alignof(T));
+        }
+    }
+
+    /**
+     * @return An allocator for temporaries that do not outlive the current operation: the calling thread's arena
+     * while an ArenaScope is active, otherwise the global heap.
+     */
+    static LimbAllocator scratch() noexcept {
+        return LimbAllocator(LimbArena::current());
+    }
+
+    [[nodiscard]] LimbAllocator select_on_container_copy_construction() const {
+        return LimbAllocator();
+    }
+
+    [[nodiscard]] std::pmr::memory_resource *resource() const {
+        return memory;
+    }
+
+    template<class U>
+    bool operator==(const LimbAllocator<U> &other) const noexcept {
+        return memory == other.memory;
+    }
+
+    template<class U>
+    bool operator!=(const LimbAllocator<U> &other) const noexcept {
+        return memory != other.memory;
+    }
+};
+
+#endif
@@ -0,0 +1,288 @@
+#include "LinearProgram.hpp"
+
+#include <stdexcept>
+
+#include "BigInt.hpp"
+
+/**
+ * The constraint matrix of a program in the standard form A x = b, x >= 0, b >= 0, with integer entries stored
+ * sparsely column by column. The columns are in Bland's order: the original variables, then the slack and surplus
+ * variables, then the artificial ones.
+ */
+struct StandardForm {
+    std::size_t rows = 0;
+    std::vector<std::vector<std::pair<std::size_t, BigInt>>> columns;
+    std::size_t firstArtificial = 0;
+};
+
+/**
+ * The state of the revised simplex: the basic column of each row, and, with D the determinant of the basis B, the
+ * integer matrix D B^-1 and the integer vector D B^-1 b. D is kept positive, so the basic values are values / D.
+ */
+struct Basis {
+    std::vector<std::size_t> variables;
+    std::vector<char> basic;
+    std::vector<BigInt> inverse;
+    std::vector<BigInt> values;
+    BigInt determinant = 1;
+};
+
+/**
+ * @return The least common multiple of the denominators, as a BigInt.
+ */
+static BigInt commonDenominator(const std::vector<const Fraction *> &fractions) {
+    BigInt scale = 1;
+    for (const Fraction *fraction: fractions) {
+        BigInt denominator = fraction->getDenominator();
+        scale = scale / BigInt::gcd(scale, denominator) * denominator;
+    }
+    return scale;
+}
+
+/**
+ * @return fraction * scale, where scale is a multiple of its denominator.
+ */
+static BigInt scaleFraction(const Fraction &fraction, const BigInt &scale) {
+    return BigInt(fraction.getNumerator()) * (scale / BigInt(fraction.getDenominator()));
+}
+
+/**
+ * @return D B^-1 a for column a of the program.
+ */
+static std::vector<BigInt> basisColumn(const StandardForm &form, const Basis &basis, std::size_t column) {
+    std::size_t rows = form.rows;
+    std::vector<BigInt> result(rows);
+    for (const auto &[row, value]: form.columns[column]) {
+        for (std::size_t i = 0; i < rows; ++i) {
+            const BigInt &entry = basis.inverse[i * rows + row];
+            if (!entry.isZero()) result[i] += entry * value;
+        }
+    }
+    return result;
+}
+
+/**
+ * Brings column into the basis in place of the basic variable of row, given alpha = D B^-1 a for the column. The new
+ * determinant is alpha[row], and every other row i of D B^-1 and of D B^-1 b becomes
+ * (alpha[row] * row_i - alpha[i] * row_pivot) / D, a division that is always exact.
+ */
+static void pivot(const StandardForm &form, Basis &basis, std::size_t row, std::size_t column,
+                  const std::vector<BigInt> &alpha) {
+    std::size_t rows = form.rows;
+    const BigInt &pivotValue = alpha[row];
+    for (std::size_t i = 0; i < rows; ++i) {
+        if (i == row) continue;
+        BigInt *entries = &basis.inverse[i * rows];
+        const BigInt *pivotEntries = &basis.inverse[row * rows];
+        for (std::size_t k = 0; k < rows; ++k) {
+            if (alpha[i].isZero() || pivotEntries[k].isZero()) {
+                if (!entries[k].isZero()) entries[k] = pivotValue * entries[k] / basis.determinant;
+            } else {
+                entries[k] = (pivotValue * entries[k] - alpha[i] * pivotEntries[k]) / basis.determinant;
+            }
+        }
+        basis.values[i] = (pivotValue * basis.values[i] - alpha[i] * basis.values[row]) / basis.determinant;
+    }
+    basis.determinant = pivotValue;
+    if (basis.determinant.sign() < 0) {
+        for (BigInt &entry: basis.inverse) entry = -entry;
+        for (BigInt &value: basis.values) value = -value;
+        basis.determinant = -basis.determinant;
+    }
+    basis.basic[basis.variables[row]] = 0;
+    basis.basic[column] = 1;
+    basis.variables[row] = column;
+}
+
+/**
+ * Maximizes cost x from a feasible basis with Bland's rule: the entering column is the first one with a positive
+ * reduced cost, and ties in the ratio test go to the row whose basic variable comes first. Reduced costs are priced
+ * from pi = c_B D B^-1 against the sparse columns, scaled by D: D c_j - pi a_j.
+ * @param entering The number of columns that may enter; artificial columns are excluded in phase 2.
+ * @param pivots Incremented for every pivot.
+ * @return false if the objective is unbounded.
+ */
+static bool runSimplex(const StandardForm &form, Basis &basis, const std::vector<BigInt> &cost, std::size_t entering,
+                       std::size_t &pivots) {
+    std::size_t rows = form.rows;
+    while (true) {
+        std::vector<BigInt> prices(rows);
+        for (std::size_t i = 0; i < rows; ++i) {
+            const BigInt &basicCost = cost[basis.variables[i]];
+            if (basicCost.isZero()) continue;
+            for (std::size_t k = 0; k < rows; ++k) {
+                if (!basis.inverse[i * rows + k].isZero()) prices[k] += basicCost * basis.inverse[i * rows + k];
+            }
+        }
+
+        std::size_t column = entering;
+        for (std::size_t j = 0; j < entering && column == entering; ++j) {
+            if (basis.basic[j] != 0) continue;
+            BigInt reducedCost = basis.determinant * cost[j];
+            for (const auto &[row, value]: form.columns[j]) {
+                if (!prices[row].isZero()) reducedCost -= prices[row] * value;
+            }
+            if (reducedCost.sign() > 0) column = j;
+        }
+        if (column == entering) return true;
+
+        std::vector<BigInt> alpha = basisColumn(form, basis, column);
+        std::size_t leaving = rows;
+        for (std::size_t i = 0; i < rows; ++i) {
+            if (alpha[i].sign() <= 0) continue;
+            if (leaving == rows) {
+                leaving = i;
+                continue;
+            }
+            int order = BigInt::compare(basis.values[i] * alpha[leaving], basis.values[leaving] * alpha[i]);
+            if (order < 0 || (order == 0 && basis.variables[i] < basis.variables[leaving])) leaving = i;
+        }
+        if (leaving == rows) return false;
+        pivot(form, basis, leaving, column, alpha);
+        ++pivots;
+    }
+}
+
+LinearProgram::LinearProgram(std::size_t variables) : variableCount(variables), objective(variables) {}
+
+std::size_t LinearProgram::variables() const {
+    return variableCount;
+}
+
+std::size_t LinearProgram::constraintCount() const {
+    return constraints.size();
+}
+
+/**
+ * Sets the objective coefficient of a variable; coefficients not set are 0.
+ * @throws std::invalid_argument If the variable does not exist.
+ */
+void LinearProgram::setObjective(std::size_t variable, const Fraction &coefficient) {
+    if (variable >= variableCount) throw std::invalid_argument("Variable index out of range");
+    objective[variable] = coefficient;
+}
+
+/**
+ * Adds the constraint sum(coefficient * x_variable) relation bound. Terms naming the same variable add up.
+ * @throws std::invalid_argument If a term names a variable that does not exist.
+ */
+void LinearProgram::addConstraint(const std::vector<std::pair<std::size_t, Fraction>> &terms, Relation relation,
+                                  const Fraction &bound) {
+    for (const auto &term: terms) {
+        if (term.first >= variableCount) throw std::invalid_argument("Variable index out of range");
+    }
+    constraints.push_back({terms, relation, bound});
+}
+
+LinearProgram::Solution LinearProgram::maximize() const {
+    return optimize(true);
+}
+
+LinearProgram::Solution LinearProgram::minimize() const {
+    return optimize(false);
+}
+
+/**
+ * Builds the standard form, finds a feasible basis in phase 1 by maximizing minus the sum of the artificial variables,
+ * drives the artificial variables left at zero out of the basis where the constraints allow, and optimizes the
+ * objective in phase 2.
+ */
+LinearProgram::Solution LinearProgram::optimize(bool maximizing) const {
+    std::size_t rows = constraints.size();
+    std::vector<std::vector<BigInt>> coefficients(rows, std::vector<BigInt>(variableCount));
+    std::vector<BigInt> bounds(rows);
+    std::vector<Relation> relations(rows);
+    for (std::size_t row = 0; row < rows; ++row) {
+        const Constraint &constraint = constraints[row];
+        std::vector<const Fraction *> fractions{&constraint.bound};
+        for (const auto &term: constraint.terms) fractions.push_back(&term.second);
+        BigInt scale = commonDenominator(fractions);
+        for (const auto &[variable, coefficient]: constraint.terms) {
+            coefficients[row][variable] += scaleFraction(coefficient, scale);
+        }
+        bounds[row] = scaleFraction(constraint.bound, scale);
+        relations[row] = constraint.relation;
+        if (bounds[row].sign() < 0) {
+            for (BigInt &coefficient: coefficients[row]) coefficient = -coefficient;
+            bounds[row] = -bounds[row];
+            if (relations[row] != Relation::Equal) {
+                relations[row] = relations[row] == Relation::LessEqual ? Relation::GreaterEqual : Relation::LessEqual;
+            }
+        }
+    }
+
+    StandardForm form;
+    form.rows = rows;
+    form.columns.resize(variableCount);
+    for (std::size_t variable = 0; variable < variableCount; ++variable) {
+        for (std::size_t row = 0; row < rows; ++row) {
+            const BigInt &coefficient = coefficients[row][variable];
+            if (!coefficient.isZero()) form.columns[variable].emplace_back(row, coefficient);
+        }
+    }
+    Basis basis;
+    basis.variables.resize(rows);
+    for (std::size_t row = 0; row < rows; ++row) {
+        if (relations[row] == Relation::Equal) continue;
+        if (relations[row] == Relation::LessEqual) basis.variables[row] = form.columns.size();
+        form.columns.push_back({{row, BigInt(relations[row] == Relation::LessEqual ? 1 : -1)}});
+    }
+    form.firstArtificial = form.columns.size();
+    for (std::size_t row = 0; row < rows; ++row) {
+        if (relations[row] == Relation::LessEqual) continue;
+        basis.variables[row] = form.columns.size();
+        form.columns.push_back({{row, BigInt(1)}});
+    }
+    basis.basic.assign(form.columns.size(), 0);
+    for (std::size_t variable: basis.variables) basis.basic[variable] = 1;
+    basis.inverse.resize(rows * rows);
+    for (std::size_t row = 0; row < rows; ++row) basis.inverse[row * rows + row] = 1;
+    basis.values = bounds;
+
+    Solution solution;
+    std::vector<BigInt> cost(form.columns.size());
+    for (std::size_t column = form.firstArtificial; column < form.columns.size(); ++column) cost[column] = -1;
+    runSimplex(form, basis, cost, form.columns.size(), solution.pivots);
+    for (std::size_t row = 0; row < rows; ++row) {
+        if (basis.variables[row] >= form.firstArtificial && !basis.values[row].isZero()) return solution;
+    }
+
+    for (std::size_t row = 0; row < rows; ++row) {
+        if (basis.variables[row] < form.firstArtificial) continue;
+        for (std::size_t column = 0; column < form.firstArtificial; ++column) {
+            if (basis.basic[column] != 0) continue;
+            std::vector<BigInt> alpha = basisColumn(form, basis, column);
+            if (alpha[row].isZero()) continue;
+            pivot(form, basis, row, column, alpha);
+            ++solution.pivots;
+            break;
+        }
+    }
+
+    std::vector<const Fraction *> fractions;
+    for (const Fraction &coefficient: objective) fractions.push_back(&coefficient);
+    BigInt scale = commonDenominator(fractions);
+    cost.assign(form.columns.size(), BigInt());
+    for (std::size_t variable = 0; variable < variableCount; ++variable) {
+        BigInt scaled = scaleFraction(objective[variable], scale);
+        cost[variable] = maximizing ? scaled : -scaled;
+    }
+    if (!runSimplex(form, basis, cost, form.firstArtificial, solution.pivots)) {
+        solution.status = Status::Unbounded;
+        return solution;
+    }
+
+    solution.status = Status::Optimal;
+    solution.values.assign(variableCount, BigFraction());
+    for (std::size_t row = 0; row < rows; ++row) {
+        if (basis.variables[row] < variableCount) {
+            solution.values[basis.variables[row]] = BigFraction(basis.values[row], basis.determinant);
+        }
+    }
+    for (std::size_t variable = 0; variable < variableCount; ++variable) {
+        if (objective[variable].getNumerator() != 0) {
+            solution.objective += BigFraction(objective[variable]) * solution.values[variable];
+        }
+    }
+    return solution;
+}
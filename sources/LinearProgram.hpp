@@ -0,0 +1,75 @@
+#ifndef FRACTION_LINEAR_PROGRAM_HPP
+#define FRACTION_LINEAR_PROGRAM_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+#include "BigFraction.hpp"
+#include "Fraction.hpp"
+
+/**
+ * A linear program over Fractions, optimized exactly: max or min c x subject to linear constraints and x >= 0.
+ *
+ * The solver is a two-phase revised simplex with Bland's rule, which cannot cycle. Each constraint is scaled free of
+ * denominators and stored as sparse integer columns; the basis inverse is kept as an integer matrix over the basis
+ * determinant and updated by integer-preserving pivots, whose divisions are exact. Intermediates are BigInts, so
+ * nothing overflows, and no gcd is taken until the solution is read out as BigFractions.
+ */
+class LinearProgram {
+
+public:
+
+    enum class Relation : std::uint8_t {
+        LessEqual,
+        GreaterEqual,
+        Equal
+    };
+
+    enum class Status : std::uint8_t {
+        Optimal,
+        Infeasible,
+        Unbounded
+    };
+
+    struct Solution {
+        Status status = Status::Infeasible;
+        BigFraction objective;
+        std::vector<BigFraction> values;
+        std::size_t pivots = 0;
+    };
+
+private:
+
+    struct Constraint {
+        std::vector<std::pair<std::size_t, Fraction>> terms;
+        Relation relation;
+        Fraction bound;
+    };
+
+    std::size_t variableCount;
+    std::vector<Fraction> objective;
+    std::vector<Constraint> constraints;
+
+    [[nodiscard]] Solution optimize(bool maximizing) const;
+
+public:
+
+    explicit LinearProgram(std::size_t variables);
+
+    [[nodiscard]] std::size_t variables() const;
+
+    [[nodiscard]] std::size_t constraintCount() const;
+
+    void setObjective(std::size_t variable, const Fraction &coefficient);
+
+    void addConstraint(const std::vector<std::pair<std::size_t, Fraction>> &terms, Relation relation,
+                       const Fraction &bound);
+
+    [[nodiscard]] Solution maximize() const;
+
+    [[nodiscard]] Solution minimize() const;
+};
+
+#endif
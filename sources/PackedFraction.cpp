@@ -0,0 +1,233 @@
+#include "PackedFraction.hpp"
+
+#include <limits>
+#include <numeric>
+#include <stdexcept>
+
+/**
+ * Reduces n/d in place, with a positive denominator.
+ * @param n The numerator, computed in 64-bit arithmetic.
+ * @param d The non-zero denominator, computed in 64-bit arithmetic.
+ * @return True if the reduced numerator and denominator fit in 16 bits.
+ */
+bool PackedFraction::reduce(std::int64_t &n, std::int64_t &d) {
+    if (d < 0) {
+        n = -n;
+        d = -d;
+    }
+    std::int64_t gcd = std::gcd(n, d);
+    n /= gcd;
+    d /= gcd;
+    return n >= std::numeric_limits<std::int16_t>::min() && n <= std::numeric_limits<std::int16_t>::max() &&
+           d <= std::numeric_limits<std::uint16_t>::max();
+}
+
+/**
+ * Reduces n/d and narrows it into 16-bit parts.
+ * @throws std::overflow_error If the reduced numerator or denominator does not fit in 16 bits.
+ * @return The reduced PackedFraction.
+ */
+PackedFraction PackedFraction::narrow(std::int64_t n, std::int64_t d) {
+    if (!reduce(n, d)) throw std::overflow_error("Fraction does not fit in a PackedFraction");
+    PackedFraction result;
+    result.numerator = static_cast<std::int16_t>(n);
+    result.denominator = static_cast<std::uint16_t>(d);
+    return result;
+}
+
+/**
+ * Reduces n/d and keeps it packed if it fits in 16-bit parts, widening it to a Fraction otherwise.
+ * @throws std::overflow_error If the reduced numerator or denominator does not fit in an int either.
+ */
+PackedResult PackedFraction::combine(std::int64_t n, std::int64_t d) {
+    bool packed = reduce(n, d);
+    if (!packed && (n < std::numeric_limits<int>::min() || n > std::numeric_limits<int>::max() ||
+                    d > std::numeric_limits<int>::max())) {
+        throw std::overflow_error("Integer overflow");
+    }
+    return {Fraction::fromReduced(static_cast<int>(n), static_cast<int>(d)), packed};
+}
+
+PackedFraction::PackedFraction() : numerator(0), denominator(1) {}
+
+/**
+ * Constructs a reduced PackedFraction from a numerator and a denominator.
+ * @param n The numerator.
+ * @param d The denominator.
+ * @throws std::invalid_argument If the denominator is 0.
+ * @throws std::overflow_error If the reduced fraction does not fit in 16-bit parts.
+ */
+PackedFraction::PackedFraction(int n, int d) : PackedFraction() {
+    if (d == 0) throw std::invalid_argument("0");
+    *this = narrow(n, d);
+}
+
+/**
+ * Narrows a Fraction into a PackedFraction.
+ * @param fraction The Fraction to narrow.
+ * @throws std::overflow_error If the numerator or denominator of the reduced fraction does not fit in 16 bits.
+ */
+PackedFraction::PackedFraction(const Fraction &fraction) : PackedFraction() {
+    *this = narrow(fraction.getNumerator(), fraction.getDenominator());
+}
+
+/**
+ * @param fraction The Fraction to check.
+ * @return True if the Fraction can be narrowed into a PackedFraction without loss.
+ */
+bool PackedFraction::fits(const Fraction &fraction) {
+    int n = fraction.getNumerator();
+    int d = fraction.getDenominator();
+    return n >= std::numeric_limits<std::int16_t>::min() && n <= std::numeric_limits<std::int16_t>::max() &&
+           d <= std::numeric_limits<std::uint16_t>::max();
+}
+
+/**
+ * Widens this PackedFraction into a Fraction. The parts are already reduced, so no gcd is computed.
+ * @return The equal Fraction.
+ */
+Fraction PackedFraction::toFraction() const {
+    return Fraction::fromReduced(numerator, denominator);
+}
+
+int PackedFraction::getNumerator() const {
+    return numerator;
+}
+
+int PackedFraction::getDenominator() const {
+    return denominator;
+}
+
+/**
+ * Prints the PackedFraction as "numerator/denominator", like Fraction.
+ */
+std::ostream &operator<<(std::ostream &out, const PackedFraction &fraction) {
+    return out << fraction.getNumerator() << '/' << fraction.getDenominator();
+}
+
+/**
+ * Adds two PackedFractions by cross-multiplying in 64-bit arithmetic, with a single reduction.
+ * @throws std::overflow_error If the reduced sum does not fit in a Fraction either.
+ */
+PackedResult PackedFraction::operator+(const PackedFraction &other) const {
+    return combine(std::int64_t{numerator} * other.denominator + std::int64_t{other.numerator} * denominator,
+                   std::int64_t{denominator} * other.denominator);
+}
+
+/**
+ * Subtracts two PackedFractions by cross-multiplying in 64-bit arithmetic, with a single reduction.
+ * @throws std::overflow_error If the reduced difference does not fit in a Fraction either.
+ */
+PackedResult PackedFraction::operator-(const PackedFraction &other) const {
+    return combine(std::int64_t{numerator} * other.denominator - std::int64_t{other.numerator} * denominator,
+                   std::int64_t{denominator} * other.denominator);
+}
+
+/**
+ * Multiplies two PackedFractions in 64-bit arithmetic, with a single reduction.
+ * @throws std::overflow_error If the reduced product does not fit in a Fraction either.
+ */
+PackedResult PackedFraction::operator*(const PackedFraction &other) const {
+    return combine(std::int64_t{numerator} * other.numerator, std::int64_t{denominator} * other.denominator);
+}
+
+/**
+ * Divides two PackedFractions in 64-bit arithmetic, with a single reduction.
+ * @throws std::runtime_error If the other PackedFraction is 0.
+ * @throws std::overflow_error If the reduced quotient does not fit in a Fraction either.
+ */
+PackedResult PackedFraction::operator/(const PackedFraction &other) const {
+    if (other.numerator == 0) throw std::runtime_error("Division by 0 is not defined.");
+    return combine(std::int64_t{numerator} * other.denominator, std::int64_t{denominator} * other.numerator);
+}
+
+Fraction PackedFraction::operator+(const Fraction &other) const {
+    return toFraction() + other;
+}
+
+Fraction PackedFraction::operator-(const Fraction &other) const {
+    return toFraction() - other;
+}
+
+Fraction PackedFraction::operator*(const Fraction &other) const {
+    return toFraction() * other;
+}
+
+Fraction PackedFraction::operator/(const Fraction &other) const {
+    return toFraction() / other;
+}
+
+Fraction operator+(const Fraction &fraction, const PackedFraction &packed) {
+    return fraction + packed.toFraction();
+}
+
+Fraction operator-(const Fraction &fraction, const PackedFraction &packed) {
+    return fraction - packed.toFraction();
+}
+
+Fraction operator*(const Fraction &fraction, const PackedFraction &packed) {
+    return fraction * packed.toFraction();
+}
+
+Fraction operator/(const Fraction &fraction, const PackedFraction &packed) {
+    return fraction / packed.toFraction();
+}
+
+/**
+ * PackedFractions are always reduced, so equality is a comparison of the parts.
+ */
+bool PackedFraction::operator==(const PackedFraction &other) const {
+    return numerator == other.numerator && denominator == other.denominator;
+}
+
+bool PackedFraction::operator!=(const PackedFraction &other) const {
+    return !((*this) == other);
+}
+
+/**
+ * Orders two PackedFractions by cross-multiplication; the products always fit in 32 bits.
+ */
+bool PackedFraction::operator<(const PackedFraction &other) const {
+    return std::int32_t{numerator} * other.denominator < std::int32_t{other.numerator} * denominator;
+}
+
+bool PackedFraction::operator>(const PackedFraction &other) const {
+    return other < (*this);
+}
+
+bool PackedFraction::operator<=(const PackedFraction &other) const {
+    return !(other < (*this));
+}
+
+bool PackedFraction::operator>=(const PackedFraction &other) const {
+    return !((*this) < other);
+}
+
+PackedResult::PackedResult(const Fraction &value, bool packed) : value(value), packed(packed) {}
+
+/**
+ * @return True if the result fits in a PackedFraction.
+ */
+bool PackedResult::isPacked() const {
+    return packed;
+}
+
+/**
+ * Narrows the result into a PackedFraction. Its parts are already reduced, so no gcd is computed.
+ * @throws std::overflow_error If the result does not fit in a PackedFraction.
+ */
+PackedFraction PackedResult::toPacked() const {
+    if (!packed) throw std::overflow_error("Fraction does not fit in a PackedFraction");
+    PackedFraction result;
+    result.numerator = static_cast<std::int16_t>(value.getNumerator());
+    result.denominator = static_cast<std::uint16_t>(value.getDenominator());
+    return result;
+}
+
+const Fraction &PackedResult::toFraction() const {
+    return value;
+}
+
+std::ostream &operator<<(std::ostream &out, const PackedResult &result) {
+    return out << result.value;
+}
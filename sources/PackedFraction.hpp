@@ -0,0 +1,114 @@
+#ifndef FRACTION_PACKED_FRACTION_HPP
+#define FRACTION_PACKED_FRACTION_HPP
+
+#include <cstdint>
+#include <iostream>
+
+#include "Fraction.hpp"
+
+class PackedResult;
+
+/**
+ * A reduced fraction packed into 32 bits: a 16-bit signed numerator and a 16-bit unsigned denominator.
+ * Intended for large in-memory tables; arithmetic between PackedFractions is carried out in 64-bit intermediates with
+ * a single reduction and yields a PackedResult, which stays packed when the result fits in 16-bit parts and widens to
+ * a Fraction otherwise. Mixed operations with Fraction widen to Fraction.
+ */
+class PackedFraction {
+
+private:
+
+    std::int16_t numerator;
+    std::uint16_t denominator;
+
+    friend class PackedResult;
+
+    static bool reduce(std::int64_t &n, std::int64_t &d);
+
+    static PackedFraction narrow(std::int64_t n, std::int64_t d);
+
+    static PackedResult combine(std::int64_t n, std::int64_t d);
+
+public:
+
+    PackedFraction();
+
+    PackedFraction(int numerator, int denominator);
+
+    explicit PackedFraction(const Fraction &fraction);
+
+    static bool fits(const Fraction &fraction);
+
+    [[nodiscard]] Fraction toFraction() const;
+
+    [[nodiscard]] int getNumerator() const;
+
+    [[nodiscard]] int getDenominator() const;
+
+    friend std::ostream &operator<<(std::ostream &outstream, const PackedFraction &fraction);
+
+    PackedResult operator+(const PackedFraction &other) const;
+
+    PackedResult operator-(const PackedFraction &other) const;
+
+    PackedResult operator*(const PackedFraction &other) const;
+
+    PackedResult operator/(const PackedFraction &other) const;
+
+    Fraction operator+(const Fraction &other) const;
+
+    Fraction operator-(const Fraction &other) const;
+
+    Fraction operator*(const Fraction &other) const;
+
+    Fraction operator/(const Fraction &other) const;
+
+    friend Fraction operator+(const Fraction &fraction, const PackedFraction &packed);
+
+    friend Fraction operator-(const Fraction &fraction, const PackedFraction &packed);
+
+    friend Fraction operator*(const Fraction &fraction, const PackedFraction &packed);
+
+    friend Fraction operator/(const Fraction &fraction, const PackedFraction &packed);
+
+    bool operator==(const PackedFraction &other) const;
+
+    bool operator!=(const PackedFraction &other) const;
+
+    bool operator<(const PackedFraction &other) const;
+
+    bool operator>(const PackedFraction &other) const;
+
+    bool operator<=(const PackedFraction &other) const;
+
+    bool operator>=(const PackedFraction &other) const;
+};
+
+static_assert(sizeof(PackedFraction) == 4, "PackedFraction must stay 32 bits wide");
+
+/**
+ * The result of arithmetic between two PackedFractions: packed when it fits in 16-bit parts, and a Fraction otherwise.
+ */
+class PackedResult {
+
+private:
+
+    Fraction value;
+    bool packed;
+
+    friend class PackedFraction;
+
+    PackedResult(const Fraction &value, bool packed);
+
+public:
+
+    [[nodiscard]] bool isPacked() const;
+
+    [[nodiscard]] PackedFraction toPacked() const;
+
+    [[nodiscard]] const Fraction &toFraction() const;
+
+    friend std::ostream &operator<<(std::ostream &outstream, const PackedResult &result);
+};
+
+#endif
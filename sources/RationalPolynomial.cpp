@@ -0,0 +1,278 @@
+#include "RationalPolynomial.hpp"
+
+#include <algorithm>
+#include <limits>
+#include <stdexcept>
+#include <utility>
+
+/**
+ * Homogenized Horner on 64-bit words: for the point u / v, sums a_i u^i v^(n - i) from the top coefficient down, so
+ * that the value is that sum over denominator * v^n.
+ * @return false if an intermediate overflows, with the outputs unspecified.
+ */
+static bool narrowHorner(const std::vector<std::int64_t> &numerators, std::int64_t denominator, std::int64_t u,
+                         std::int64_t v, std::int64_t &valueNumerator, std::int64_t &valueDenominator) {
+    std::int64_t sum = numerators.back();
+    std::int64_t power = 1;
+    for (std::size_t i = numerators.size() - 1; i-- > 0;) {
+        std::int64_t term = 0;
+        if (__builtin_mul_overflow(power, v, &power) || __builtin_mul_overflow(sum, u, &sum) ||
+            __builtin_mul_overflow(numerators[i], power, &term) || __builtin_add_overflow(sum, term, &sum)) {
+            return false;
+        }
+    }
+    valueNumerator = sum;
+    return !__builtin_mul_overflow(denominator, power, &valueDenominator);
+}
+
+RationalPolynomial::RationalPolynomial() = default;
+
+RationalPolynomial::RationalPolynomial(const Fraction &constant)
+        : RationalPolynomial(std::vector<Fraction>{constant}) {}
+
+/**
+ * Constructs the polynomial with the given coefficients, the constant term first.
+ */
+RationalPolynomial::RationalPolynomial(const std::vector<Fraction> &coefficients) {
+    for (const Fraction &coefficient: coefficients) {
+        BigInt d = coefficient.getDenominator();
+        denominator = denominator / BigInt::gcd(denominator, d) * d;
+    }
+    numerators.reserve(coefficients.size());
+    for (const Fraction &coefficient: coefficients) {
+        BigInt scale = denominator / BigInt(coefficient.getDenominator());
+        numerators.push_back(BigInt(coefficient.getNumerator()) * scale);
+    }
+    normalize();
+}
+
+RationalPolynomial::RationalPolynomial(std::initializer_list<Fraction> coefficients)
+        : RationalPolynomial(std::vector<Fraction>(coefficients)) {}
+
+/**
+ * Builds a polynomial from integer numerators over a nonzero denominator, which may have any sign.
+ */
+RationalPolynomial RationalPolynomial::fromParts(std::vector<BigInt> numerators, BigInt denominator) {
+    RationalPolynomial result;
+    result.numerators = std::move(numerators);
+    result.denominator = std::move(denominator);
+    if (result.denominator.sign() < 0) {
+        for (BigInt &numerator: result.numerators) numerator = -numerator;
+        result.denominator = -result.denominator;
+    }
+    result.normalize();
+    return result;
+}
+
+/**
+ * Restores the canonical form: drops zero leading numerators, divides out the gcd of the denominator and all the
+ * numerators, and refreshes the 64-bit copies used by evaluate.
+ */
+void RationalPolynomial::normalize() {
+    while (!numerators.empty() && numerators.back().isZero()) numerators.pop_back();
+    if (numerators.empty()) denominator = 1;
+    BigInt gcd = denominator;
+    for (std::size_t i = 0; i < numerators.size() && gcd != BigInt(1); ++i) gcd = BigInt::gcd(gcd, numerators[i]);
+    if (gcd != BigInt(1)) {
+        for (BigInt &numerator: numerators) numerator /= gcd;
+        denominator /= gcd;
+    }
+
+    narrowNumerators.clear();
+    bool fits = denominator.fitsInt64();
+    for (std::size_t i = 0; i < numerators.size() && fits; ++i) fits = numerators[i].fitsInt64();
+    if (!fits) return;
+    narrowDenominator = denominator.toInt64();
+    for (const BigInt &numerator: numerators) narrowNumerators.push_back(numerator.toInt64());
+}
+
+/**
+ * @return The highest power with a nonzero coefficient; 0 for constants, including the zero polynomial.
+ */
+std::size_t RationalPolynomial::degree() const {
+    return numerators.empty() ? 0 : numerators.size() - 1;
+}
+
+bool RationalPolynomial::isZero() const {
+    return numerators.empty();
+}
+
+/**
+ * @return The coefficient of x^power; 0 above the degree.
+ */
+BigFraction RationalPolynomial::coefficient(std::size_t power) const {
+    if (power >= numerators.size()) return {};
+    return {numerators[power], denominator};
+}
+
+/**
+ * Evaluates the polynomial exactly. For the point u / v this is sum(a_i u^i v^(n - i)) / (denominator * v^n),
+ * accumulated by Horner's method without any gcd and reduced once at the end.
+ */
+BigFraction RationalPolynomial::evaluate(const Fraction &point) const {
+    if (numerators.empty()) return {};
+    std::int64_t u = point.getNumerator();
+    std::int64_t v = point.getDenominator();
+    std::int64_t valueNumerator = 0;
+    std::int64_t valueDenominator = 1;
+    if (!narrowNumerators.empty() &&
+        narrowHorner(narrowNumerators, narrowDenominator, u, v, valueNumerator, valueDenominator)) {
+        return {valueNumerator, valueDenominator};
+    }
+    BigInt bigU = u;
+    BigInt bigV = v;
+    BigInt sum = numerators.back();
+    BigInt power = 1;
+    for (std::size_t i = numerators.size() - 1; i-- > 0;) {
+        power *= bigV;
+        sum = sum * bigU + numerators[i] * power;
+    }
+    return {sum, denominator * power};
+}
+
+/**
+ * Evaluates the polynomial at count points, writing the values to results.
+ */
+void RationalPolynomial::evaluate(const Fraction *points, std::size_t count, BigFraction *results) const {
+    for (std::size_t i = 0; i < count; ++i) results[i] = evaluate(points[i]);
+}
+
+/**
+ * @return The nonzero terms from the highest power down, such as "1/2*x^2 + -3/1*x + 1/4"; "0" for the zero
+ * polynomial.
+ */
+std::string RationalPolynomial::toString() const {
+    if (numerators.empty()) return "0";
+    std::string result;
+    for (std::size_t power = numerators.size(); power-- > 0;) {
+        if (numerators[power].isZero()) continue;
+        if (!result.empty()) result += " + ";
+        result += coefficient(power).toString();
+        if (power >= 1) result += "*x";
+        if (power >= 2) result += "^" + std::to_string(power);
+    }
+    return result;
+}
+
+std::ostream &operator<<(std::ostream &outstream, const RationalPolynomial &polynomial) {
+    return outstream << polynomial.toString();
+}
+
+RationalPolynomial RationalPolynomial::operator-() const {
+    RationalPolynomial result = *this;
+    for (BigInt &numerator: result.numerators) numerator = -numerator;
+    for (std::int64_t &numerator: result.narrowNumerators) {
+        if (numerator == std::numeric_limits<std::int64_t>::min()) {
+            result.narrowNumerators.clear();
+            break;
+        }
+        numerator = -numerator;
+    }
+    return result;
+}
+
+/**
+ * Adds the numerators over the least common multiple of the denominators.
+ */
+RationalPolynomial operator+(const RationalPolynomial &left, const RationalPolynomial &right) {
+    BigInt gcd = BigInt::gcd(left.denominator, right.denominator);
+    BigInt leftScale = right.denominator / gcd;
+    BigInt rightScale = left.denominator / gcd;
+    std::vector<BigInt> numerators(std::max(left.numerators.size(), right.numerators.size()));
+    for (std::size_t i = 0; i < left.numerators.size(); ++i) numerators[i] = left.numerators[i] * leftScale;
+    for (std::size_t i = 0; i < right.numerators.size(); ++i) numerators[i] += right.numerators[i] * rightScale;
+    return RationalPolynomial::fromParts(std::move(numerators), left.denominator * leftScale);
+}
+
+RationalPolynomial operator-(const RationalPolynomial &left, const RationalPolynomial &right) {
+    return left + -right;
+}
+
+/**
+ * Convolves the numerators and multiplies the denominators.
+ */
+RationalPolynomial operator*(const RationalPolynomial &left, const RationalPolynomial &right) {
+    if (left.isZero() || right.isZero()) return {};
+    std::vector<BigInt> numerators(left.numerators.size() + right.numerators.size() - 1);
+    for (std::size_t i = 0; i < left.numerators.size(); ++i) {
+        if (left.numerators[i].isZero()) continue;
+        for (std::size_t j = 0; j < right.numerators.size(); ++j) {
+            if (!right.numerators[j].isZero()) numerators[i + j] += left.numerators[i] * right.numerators[j];
+        }
+    }
+    return RationalPolynomial::fromParts(std::move(numerators), left.denominator * right.denominator);
+}
+
+RationalPolynomial operator/(const RationalPolynomial &left, const RationalPolynomial &right) {
+    RationalPolynomial quotient;
+    RationalPolynomial remainder;
+    RationalPolynomial::divMod(left, right, quotient, remainder);
+    return quotient;
+}
+
+RationalPolynomial operator%(const RationalPolynomial &left, const RationalPolynomial &right) {
+    RationalPolynomial quotient;
+    RationalPolynomial remainder;
+    RationalPolynomial::divMod(left, right, quotient, remainder);
+    return remainder;
+}
+
+RationalPolynomial &RationalPolynomial::operator+=(const RationalPolynomial &other) {
+    return *this = *this + other;
+}
+
+RationalPolynomial &RationalPolynomial::operator-=(const RationalPolynomial &other) {
+    return *this = *this - other;
+}
+
+RationalPolynomial &RationalPolynomial::operator*=(const RationalPolynomial &other) {
+    return *this = *this * other;
+}
+
+/**
+ * Exact polynomial division: dividend = quotient * divisor + remainder, with the degree of remainder below that of
+ * divisor. The integer numerators are pseudo-divided, which scales the dividend by a power of the divisor's leading
+ * numerator instead of dividing at every step, so no fraction is formed until quotient and remainder are each
+ * reduced once.
+ * @throws std::runtime_error If the divisor is the zero polynomial.
+ */
+void RationalPolynomial::divMod(const RationalPolynomial &dividend, const RationalPolynomial &divisor,
+                                RationalPolynomial &quotient, RationalPolynomial &remainder) {
+    if (divisor.isZero()) throw std::runtime_error("Division by 0 is not defined.");
+    if (dividend.numerators.size() < divisor.numerators.size()) {
+        remainder = dividend;
+        quotient = RationalPolynomial();
+        return;
+    }
+    std::size_t divisorDegree = divisor.degree();
+    std::size_t steps = dividend.numerators.size() - divisorDegree;
+    const BigInt &leading = divisor.numerators.back();
+    // Invariant: leading^(steps - k) * A = Q * B + R, over the integer numerators A of dividend and B of divisor.
+    std::vector<BigInt> q(steps);
+    std::vector<BigInt> r = dividend.numerators;
+    BigInt scale = 1;
+    for (std::size_t k = steps; k-- > 0;) {
+        BigInt top = std::move(r[divisorDegree + k]);
+        r.pop_back();
+        for (BigInt &coefficient: q) coefficient *= leading;
+        q[k] = top;
+        for (BigInt &coefficient: r) coefficient *= leading;
+        if (!top.isZero()) {
+            for (std::size_t i = 0; i < divisorDegree; ++i) r[k + i] -= top * divisor.numerators[i];
+        }
+        scale *= leading;
+    }
+    // A / d1 = (Q d2 / (scale d1)) (B / d2) + R / (scale d1).
+    BigInt denominator = scale * dividend.denominator;
+    for (BigInt &coefficient: q) coefficient *= divisor.denominator;
+    quotient = fromParts(std::move(q), denominator);
+    remainder = fromParts(std::move(r), std::move(denominator));
+}
+
+bool operator==(const RationalPolynomial &left, const RationalPolynomial &right) {
+    return left.denominator == right.denominator && left.numerators == right.numerators;
+}
+
+bool operator!=(const RationalPolynomial &left, const RationalPolynomial &right) {
+    return !(left == right);
+}
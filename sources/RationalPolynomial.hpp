@@ -0,0 +1,87 @@
+#ifndef FRACTION_RATIONAL_POLYNOMIAL_HPP
+#define FRACTION_RATIONAL_POLYNOMIAL_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <initializer_list>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "BigFraction.hpp"
+#include "BigInt.hpp"
+#include "Fraction.hpp"
+
+/**
+ * A polynomial with rational coefficients, stored as integer numerators over one common denominator.
+ *
+ * The representation is canonical: the denominator is positive and coprime to the numerators taken together, and the
+ * leading numerator is nonzero, so equal polynomials compare equal field by field. Arithmetic works on the integer
+ * numerators and reduces once per result. Evaluation runs Horner's method on the numerators, homogenized with powers
+ * of the point's denominator, so the value is reduced once instead of after every step; it runs in overflow-checked
+ * 64-bit arithmetic while the values fit and in BigInts otherwise.
+ */
+class RationalPolynomial {
+
+private:
+
+    std::vector<BigInt> numerators;
+    BigInt denominator = 1;
+    std::vector<std::int64_t> narrowNumerators;
+    std::int64_t narrowDenominator = 1;
+
+    static RationalPolynomial fromParts(std::vector<BigInt> numerators, BigInt denominator);
+
+    void normalize();
+
+public:
+
+    RationalPolynomial();
+
+    RationalPolynomial(const Fraction &constant);
+
+    RationalPolynomial(const std::vector<Fraction> &coefficients);
+
+    RationalPolynomial(std::initializer_list<Fraction> coefficients);
+
+    [[nodiscard]] std::size_t degree() const;
+
+    [[nodiscard]] bool isZero() const;
+
+    [[nodiscard]] BigFraction coefficient(std::size_t power) const;
+
+    [[nodiscard]] BigFraction evaluate(const Fraction &point) const;
+
+    void evaluate(const Fraction *points, std::size_t count, BigFraction *results) const;
+
+    [[nodiscard]] std::string toString() const;
+
+    friend std::ostream &operator<<(std::ostream &outstream, const RationalPolynomial &polynomial);
+
+    RationalPolynomial operator-() const;
+
+    friend RationalPolynomial operator+(const RationalPolynomial &left, const RationalPolynomial &right);
+
+    friend RationalPolynomial operator-(const RationalPolynomial &left, const RationalPolynomial &right);
+
+    friend RationalPolynomial operator*(const RationalPolynomial &left, const RationalPolynomial &right);
+
+    friend RationalPolynomial operator/(const RationalPolynomial &left, const RationalPolynomial &right);
+
+    friend RationalPolynomial operator%(const RationalPolynomial &left, const RationalPolynomial &right);
+
+    RationalPolynomial &operator+=(const RationalPolynomial &other);
+
+    RationalPolynomial &operator-=(const RationalPolynomial &other);
+
+    RationalPolynomial &operator*=(const RationalPolynomial &other);
+
+    static void divMod(const RationalPolynomial &dividend, const RationalPolynomial &divisor,
+                       RationalPolynomial &quotient, RationalPolynomial &remainder);
+
+    friend bool operator==(const RationalPolynomial &left, const RationalPolynomial &right);
+
+    friend bool operator!=(const RationalPolynomial &left, const RationalPolynomial &right);
+};
+
+#endif
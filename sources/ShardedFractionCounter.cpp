@@ -0,0 +1,129 @@
+#include "ShardedFractionCounter.hpp"
+
+#include <algorithm>
+#include <limits>
+#include <stdexcept>
+#include <thread>
+
+#include "WideArithmetic.hpp"
+
+/**
+ * Threads are numbered in order of their first add, and thread i writes to shard i modulo the shard count.
+ */
+static std::atomic<std::size_t> nextThreadSlot{0};
+
+/**
+ * Holds a shard's spin lock for the lifetime of the guard.
+ */
+class ShardGuard {
+
+private:
+
+    std::atomic_flag &flag;
+
+public:
+
+    explicit ShardGuard(std::atomic_flag &flag) : flag(flag) {
+        while (flag.test_and_set(std::memory_order_acquire)) {
+            std::this_thread::yield();
+        }
+    }
+
+    ShardGuard(const ShardGuard &) = delete;
+
+    ShardGuard &operator=(const ShardGuard &) = delete;
+
+    ~ShardGuard() {
+        flag.clear(std::memory_order_release);
+    }
+};
+
+/**
+ * Adds a/b to the reduced fraction n/d in place, over the least common denominator with 128-bit intermediates.
+ * @throws std::overflow_error If the reduced sum does not fit in 64-bit parts.
+ */
+static void addReduced(std::int64_t &n, std::int64_t &d, std::int64_t a, std::int64_t b) {
+    auto common = static_cast<__int128>(gcd128(static_cast<unsigned __int128>(d), static_cast<unsigned __int128>(b)));
+    __int128 denominator = static_cast<__int128>(d) / common * b;
+    __int128 numerator = static_cast<__int128>(n) * (b / common) + static_cast<__int128>(a) * (d / common);
+    reduce128(numerator, denominator);
+    if (numerator < std::numeric_limits<std::int64_t>::min() || numerator > std::numeric_limits<std::int64_t>::max() ||
+        denominator > std::numeric_limits<std::int64_t>::max()) {
+        throw std::overflow_error("Integer overflow");
+    }
+    n = static_cast<std::int64_t>(numerator);
+    d = static_cast<std::int64_t>(denominator);
+}
+
+/**
+ * Creates a zero counter.
+ * @param shards The number of shards; 0 uses std::thread::hardware_concurrency().
+ */
+ShardedFractionCounter::ShardedFractionCounter(std::size_t shards)
+        : count(shards == 0 ? std::max(1U, std::thread::hardware_concurrency()) : shards) {
+    this->shards = std::make_unique<Shard[]>(count);
+}
+
+std::size_t ShardedFractionCounter::shardCount() const {
+    return count;
+}
+
+ShardedFractionCounter::Shard &ShardedFractionCounter::localShard() {
+    static thread_local std::size_t slot = nextThreadSlot.fetch_add(1, std::memory_order_relaxed);
+    return shards[slot % count];
+}
+
+/**
+ * Adds numerator/denominator to the calling thread's shard. The shard lock is only contended when more threads than
+ * shards write, or while a reader merges.
+ * @throws std::overflow_error If the shard's reduced sum no longer fits in 64-bit parts; the shard is then unchanged.
+ */
+void ShardedFractionCounter::addParts(std::int64_t numerator, std::int64_t denominator) {
+    Shard &shard = localShard();
+    ShardGuard guard(shard.busy);
+    addReduced(shard.numerator, shard.denominator, numerator, denominator);
+}
+
+void ShardedFractionCounter::add(const Fraction &fraction) {
+    addParts(fraction.getNumerator(), fraction.getDenominator());
+}
+
+void ShardedFractionCounter::subtract(const Fraction &fraction) {
+    addParts(-std::int64_t{fraction.getNumerator()}, fraction.getDenominator());
+}
+
+/**
+ * Merges all shards exactly.
+ * @throws std::overflow_error If the total does not fit in a Fraction.
+ * @return The sum of every fraction added so far.
+ */
+Fraction ShardedFractionCounter::value() const {
+    std::int64_t numerator = 0;
+    std::int64_t denominator = 1;
+    for (std::size_t i = 0; i < count; ++i) {
+        std::int64_t shardNumerator = 0;
+        std::int64_t shardDenominator = 1;
+        {
+            ShardGuard guard(shards[i].busy);
+            shardNumerator = shards[i].numerator;
+            shardDenominator = shards[i].denominator;
+        }
+        addReduced(numerator, denominator, shardNumerator, shardDenominator);
+    }
+    if (numerator < std::numeric_limits<int>::min() || numerator > std::numeric_limits<int>::max() ||
+        denominator > std::numeric_limits<int>::max()) {
+        throw std::overflow_error("Integer overflow");
+    }
+    return Fraction::fromReduced(static_cast<int>(numerator), static_cast<int>(denominator));
+}
+
+/**
+ * Sets the counter back to zero.
+ */
+void ShardedFractionCounter::reset() {
+    for (std::size_t i = 0; i < count; ++i) {
+        ShardGuard guard(shards[i].busy);
+        shards[i].numerator = 0;
+        shards[i].denominator = 1;
+    }
+}
@@ -0,0 +1,53 @@
+#ifndef SHARDED_FRACTION_COUNTER_HPP
+#define SHARDED_FRACTION_COUNTER_HPP
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+#include "Fraction.hpp"
+
+/**
+ * A rational tally for many concurrent writers.
+ *
+ * Each thread adds into its own cache-line-sized shard, so writers on different shards never touch the same cache
+ * line. Shards hold reduced 64-bit numerators and denominators and add in 128-bit intermediates, so they absorb
+ * sums that would overflow Fraction::operator+. Readers merge all shards exactly; the result equals the serial sum
+ * of every added fraction.
+ */
+class ShardedFractionCounter {
+
+private:
+
+    static const std::size_t CACHE_LINE = 64;
+
+    struct alignas(CACHE_LINE) Shard {
+        std::atomic_flag busy;
+        std::int64_t numerator = 0;
+        std::int64_t denominator = 1;
+    };
+
+    std::unique_ptr<Shard[]> shards;
+    std::size_t count;
+
+    Shard &localShard();
+
+    void addParts(std::int64_t numerator, std::int64_t denominator);
+
+public:
+
+    explicit ShardedFractionCounter(std::size_t shards = 0);
+
+    [[nodiscard]] std::size_t shardCount() const;
+
+    void add(const Fraction &fraction);
+
+    void subtract(const Fraction &fraction);
+
+    [[nodiscard]] Fraction value() const;
+
+    void reset();
+};
+
+#endif
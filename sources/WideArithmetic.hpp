@@ -0,0 +1,39 @@
+#ifndef FRACTION_WIDE_ARITHMETIC_HPP
+#define FRACTION_WIDE_ARITHMETIC_HPP
+
+#include <cstdint>
+#include <numeric>
+
+/**
+ * Euclid on 128-bit words, switching to the 64-bit gcd as soon as both values fit.
+ */
+inline unsigned __int128 gcd128(unsigned __int128 a, unsigned __int128 b) {
+    while (b != 0) {
+        if ((a >> 64U) == 0 && (b >> 64U) == 0) {
+            return std::gcd(static_cast<std::uint64_t>(a), static_cast<std::uint64_t>(b));
+        }
+        unsigned __int128 rest = a % b;
+        a = b;
+        b = rest;
+    }
+    return a;
+}
+
+/**
+ * Reduces numerator / denominator in place to lowest terms with a positive denominator, for the callers that compute
+ * a rational in 128-bit intermediates and then check whether it fits their own representation.
+ * @param denominator The non-zero denominator.
+ */
+inline void reduce128(__int128 &numerator, __int128 &denominator) {
+    if (denominator < 0) {
+        numerator = -numerator;
+        denominator = -denominator;
+    }
+    auto magnitude = static_cast<unsigned __int128>(numerator);
+    if (numerator < 0) magnitude = -magnitude;
+    auto gcd = static_cast<__int128>(gcd128(magnitude, static_cast<unsigned __int128>(denominator)));
+    numerator /= gcd;
+    denominator /= gcd;
+}
+
+#endif